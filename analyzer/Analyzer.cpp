@@ -5,33 +5,84 @@
 #include "SelectionUtils.hpp"
 
 #include <iostream>
+#include <chrono>
+#include <algorithm>
 
 #include "TH1.h"
 
-Analyzer::Analyzer(TString const& tree_name, std::map<TString, Channel> const& input_file_map, TString const& pdf_file_name, Mode mode)
+Analyzer::Analyzer(TString const& tree_name, std::map<TString, Channel> const& input_file_map, TString const& pdf_file_name_sl, TString const& pdf_file_name_dl, Mode mode, Method method, Sampling sampling)
 :   m_file_map(input_file_map)
 ,   m_tree_name(tree_name)  
-,   m_estimator(pdf_file_name)
+,   m_estimator(pdf_file_name_sl, pdf_file_name_dl, method, sampling)
 ,   m_hm()   
+,   m_hme_mass_sl(m_hm.Add("hme_mass_sl", "HME X->HH mass, SL channel", {"X->HH mass, [GeV]", "Count"}, {0, 2500}, 100))
+,   m_hme_mass_dl(m_hm.Add("hme_mass_dl", "HME X->HH mass, DL channel", {"X->HH mass, [GeV]", "Count"}, {0, 2500}, 100))
+,   m_method(method)
 {
     TH1::AddDirectory(false);
-    m_hm.Add("hme_mass", "HME X->HH mass", {"X->HH mass, [GeV]", "Count"}, {0, 2500}, 100);
 }
 
-void Analyzer::ProcessFile(TString const& name, Channel ch)
+FileSummary Analyzer::ProcessFile(TString const& name, Channel ch)
 {
     TFile* file = TFile::Open(name);
     TTree* tree = static_cast<TTree*>(file->Get<TTree>(m_tree_name));
 
     m_storage.ConnectTree(tree, ch);
+    m_estimates.clear();
+    // efficiency is reported per file
+    m_estimator.Get(ch).ResetEfficiency();
+
+    m_has_matches = AttachMatchTree(tree, name, ch, m_match);
+    if (m_has_matches)
+    {
+        std::cout << "reading matching from " << MatchFileName(name, ch) << "\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
     ULong64_t n_events = tree->GetEntries();
     for (ULong64_t evt = 0; evt < n_events; ++evt)
     {
         ProcessEvent(evt, tree, ch);
     }
+    auto finish = std::chrono::steady_clock::now();
+    Float_t elapsed = std::chrono::duration<Float_t>(finish - start).count();
+
+    FileSummary summary;
+    summary.n_events = n_events;
+    summary.seconds = elapsed;
+
     std::cout << "counter=" << counter << "\n";
-    m_hm.Draw();
+    std::cout << "method: " << (m_method == Method::Weights ? "weights" : "eqns") << "\n"
+              << "processed " << n_events << " events in " << elapsed << " s (" 
+              << (elapsed > 0.0 ? n_events/elapsed : 0.0) << " events/s)\n";
+
+    // resolution: median and 68% interval of estimated masses
+    if (!m_estimates.empty())
+    {
+        size_t n = m_estimates.size();
+        std::sort(m_estimates.begin(), m_estimates.end());
+        summary.n_estimated = n;
+        summary.median = m_estimates[n/2];
+        summary.width = m_estimates[Q84*(n - 1)/100] - m_estimates[Q16*(n - 1)/100];
+        std::cout << "estimated " << n << " masses: median=" << summary.median << ", width=" << summary.width 
+                  << ", rel_width=" << summary.width/summary.median << "\n";
+    }
+
+    EstimatorBase const& estimator = m_estimator.Get(ch);
+    summary.efficiency = estimator.GetEfficiency();
+    std::cout << "sampling efficiency: " << estimator.GetNumAccepted() << "/" << estimator.GetNumIterations() 
+              << " (" << 100.0*estimator.GetEfficiency() << "%)\n"
+              << "acceptance per combination: mean=" << estimator.GetMeanCombAcceptance() << ", rms=" << estimator.GetRmsCombAcceptance()
+              << " over " << estimator.GetNumCombinations() << " combinations\n"
+              << "jet rescaling failures: " << 100.0*estimator.GetRescFailureRate() << "%\n";
     file->Close();
+    return summary;
+}
+
+void Analyzer::WriteHistograms(TString const& file_name) const
+{
+    m_hm.Write(file_name.Data());
+    std::cout << "histograms written to " << file_name << ", render with render_hists " << file_name << "\n";
 }
 
 void Analyzer::ProcessEvent(ULong64_t evt, TTree* tree, Channel ch)
@@ -53,7 +104,8 @@ void Analyzer::ProcessEvent(ULong64_t evt, TTree* tree, Channel ch)
         return;
     }
 
-    if (!IsFiducial(m_storage, jets, ch))
+    bool fiducial = m_has_matches ? IsFiducial(m_storage, m_match, ch) : IsFiducial(m_storage, jets, ch);
+    if (!fiducial)
     {
         return;
     }
@@ -99,12 +151,13 @@ void Analyzer::ProcessEvent(ULong64_t evt, TTree* tree, Channel ch)
     #endif
 
     TString chosen_comb = "";
-    // auto hme = m_estimator.EstimateMass(jets, leptons, jet_resolutions, met, evt, chosen_comb); // sl
-    auto hme = m_estimator.EstimateMass(jets, leptons, met, evt, chosen_comb);
-    // auto hme = m_estimator.EstimateMass(jets, leptons, met, evt, chosen_comb); // dl
+    auto hme = m_method == Method::Weights 
+               ? m_estimator.EstimateMass(jets, leptons, jet_resolutions, met, evt, ch, chosen_comb)
+               : m_estimator.EstimateMass(jets, leptons, met, evt, ch, chosen_comb);
     if (hme)
     {
-        m_hm.Fill("hme_mass", hme.value());
+        m_hm.Fill(ch == Channel::SL ? m_hme_mass_sl : m_hme_mass_dl, hme.value());
+        m_estimates.push_back(hme.value());
     }
 
     #ifdef DEBUG
@@ -16,6 +16,19 @@
 #include "Storage.hpp"
 #include "Estimator.hpp"
 #include "HistManager.hpp"
+#include "MatchTree.hpp"
+
+// throughput and resolution of one processed file
+struct FileSummary
+{
+    ULong64_t n_events = 0;
+    size_t n_estimated = 0;
+    Float_t seconds = 0.0;
+    // median and 68% width of estimated masses
+    Float_t median = 0.0;
+    Float_t width = 0.0;
+    Float_t efficiency = 0.0;
+};
 
 class Analyzer
 {
@@ -23,18 +36,27 @@ class Analyzer
     Storage m_storage;
     std::map<TString, Channel> m_file_map;
     TString m_tree_name;
-    // EstimatorSingLep_Run3 m_estimator;
-    // EstimatorDoubleLep_Run2 m_estimator; 
-    EstimatorSingleLep m_estimator;
+    Estimator m_estimator;
     HistManager m_hm;
+    Hist1DHandle m_hme_mass_sl;
+    Hist1DHandle m_hme_mass_dl;
+    Method m_method;
+    std::vector<Float_t> m_estimates;
+    // matching read from friend tree written by match_tree, if present for the current file
+    MatchRecord m_match;
+    bool m_has_matches = false;
 
     inline static int counter = 0;
 
     public:
-    Analyzer(TString const& tree_name, std::map<TString, Channel> const& input_file_map, TString const& pdf_file_name, Mode mode);
+    Analyzer(TString const& tree_name, std::map<TString, Channel> const& input_file_map, TString const& pdf_file_name_sl, TString const& pdf_file_name_dl, Mode mode, Method method, Sampling sampling = Sampling::Uniform);
     
-    void ProcessFile(TString const& name, Channel ch);
+    // false if estimation method has no estimator in channel ch, files of that channel can not be processed
+    inline bool HasChannel(Channel ch) const { return m_estimator.HasChannel(ch); }
+    FileSummary ProcessFile(TString const& name, Channel ch);
     void ProcessEvent(ULong64_t evt, TTree* tree, Channel ch);
+    // histograms accumulated over all processed files
+    void WriteHistograms(TString const& file_name) const;
 
     #ifdef DEBUG
         inline static std::stringstream gen_truth_buf = std::stringstream("");
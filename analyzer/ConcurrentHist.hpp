@@ -0,0 +1,139 @@
+#ifndef CONCURRENT_HIST_HPP
+#define CONCURRENT_HIST_HPP
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+#include "TH1.h"
+
+#include "HistManager.hpp"
+
+// per-thread shards of a HistManager for parallel event loops
+// thread t fills Shard(t) with handles returned by the manager, shards share nothing, so filling takes no locks
+// MergeInto adds bin arrays of all shards to the manager and clears shards,
+// it is called once threads are joined or on demand at a point where no thread is filling
+class HistShards
+{
+    public:
+    HistShards(HistManager const& hm, int n_shards)
+    {
+        if (n_shards < 1)
+        {
+            throw std::runtime_error("HistShards: number of shards must be positive");
+        }
+
+        m_shards.reserve(n_shards);
+        for (int t = 0; t < n_shards; ++t)
+        {
+            m_shards.push_back(std::make_unique<HistManager>(hm.MakeShard()));
+        }
+    }
+
+    inline int Size() const { return m_shards.size(); }
+    inline HistManager& Shard(int t) { return *m_shards[t]; }
+
+    void MergeInto(HistManager& hm)
+    {
+        for (auto& shard: m_shards)
+        {
+            hm.Merge(*shard);
+            shard->Reset();
+        }
+    }
+
+    private:
+    // shards live in separate allocations, so threads do not write to the same cache lines
+    std::vector<std::unique_ptr<HistManager>> m_shards;
+};
+
+// uniformly binned 1d histogram shared by all threads, bins are atomic
+// a fill is one relaxed compare-and-swap on its bin, so it scales while threads rarely fill the same bin at once
+// (many bins, few fills per event); for dense filling of narrow distributions HistShards is faster
+// bin 0 is underflow and bin n_bins + 1 is overflow, bin of x is found as in TAxis::FindFixBin
+class AtomicHist1D
+{
+    public:
+    AtomicHist1D(int n_bins, double xmin, double xmax)
+    :   m_n_bins(n_bins)
+    ,   m_xmin(xmin)
+    ,   m_xmax(xmax)
+    ,   m_bins(std::make_unique<std::atomic<double>[]>(n_bins + 2))
+    {
+        if (n_bins < 1 || !(xmin < xmax))
+        {
+            throw std::runtime_error("AtomicHist1D: invalid binning");
+        }
+        Reset();
+    }
+
+    inline int Bin(double x) const
+    {
+        if (x < m_xmin)
+        {
+            return 0;
+        }
+        if (!(x < m_xmax))
+        {
+            return m_n_bins + 1;
+        }
+        return 1 + static_cast<int>(m_n_bins*(x - m_xmin)/(m_xmax - m_xmin));
+    }
+
+    inline void Fill(double x, double w = 1.0)
+    {
+        std::atomic<double>& bin = m_bins[Bin(x)];
+        double old = bin.load(std::memory_order_relaxed);
+        while (!bin.compare_exchange_weak(old, old + w, std::memory_order_relaxed))
+        {}
+    }
+
+    inline double BinContent(int bin) const { return m_bins[bin].load(std::memory_order_relaxed); }
+
+    // there is no shared counter of fills, it would be written by every fill of every thread;
+    // entries are the sum of bin contents, i.e. number of fills if all fills have unit weight
+    double Entries() const
+    {
+        double entries = 0.0;
+        for (int i = 0; i <= m_n_bins + 1; ++i)
+        {
+            entries += BinContent(i);
+        }
+        return entries;
+    }
+
+    // adds contents to h with the same binning, statistics of h are recomputed from bin contents
+    void AddTo(TH1* h) const
+    {
+        if (h->GetNbinsX() != m_n_bins)
+        {
+            throw std::runtime_error("AtomicHist1D::AddTo: different number of bins");
+        }
+
+        double entries = h->GetEntries() + Entries();
+        for (int i = 0; i <= m_n_bins + 1; ++i)
+        {
+            h->AddBinContent(i, BinContent(i));
+        }
+        h->ResetStats();
+        h->SetEntries(entries);
+    }
+
+    // not safe while other threads are filling
+    void Reset()
+    {
+        for (int i = 0; i <= m_n_bins + 1; ++i)
+        {
+            m_bins[i].store(0.0, std::memory_order_relaxed);
+        }
+    }
+
+    private:
+    int m_n_bins;
+    double m_xmin;
+    double m_xmax;
+    std::unique_ptr<std::atomic<double>[]> m_bins;
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 #include <unordered_map>
+#include <vector>
 
 #include "TString.h"
 
@@ -11,6 +12,8 @@ inline constexpr int SEED = 42;
 enum class Channel { SL, DL };
 enum class Topology { Resolved, Boosted };
 enum class Mode { Validation, Estimation };
+enum class Sampling { Uniform, Importance };
+enum class Method { Eqns, Weights };
 
 enum class Lep { lep1, lep2, count };
 enum class Nu { nu1, nu2, count };
@@ -21,13 +24,13 @@ inline constexpr size_t MAX_GEN_NU = static_cast<size_t>(Nu::count);
 
 // PDFs in SL channel resolved topology
 enum class PDF1_sl { b1, q1, numet_pt, numet_dphi, nulep_deta, hh_dphi, mbb, mww, hh_deta, count };
-enum class PDF2_sl { b1b2, q1q2, mw1mw2, hh_dEtadPhi, hh_pt_e, count };
+enum class PDF2_sl { b1b2, q1q2, mw1mw2, hh_dEtadPhi, hh_pt_e, b1_pt, q1_pt, count };
 inline constexpr size_t NUM_PDF_1D_SL = static_cast<size_t>(PDF1_sl::count);
 inline constexpr size_t NUM_PDF_2D_SL = static_cast<size_t>(PDF2_sl::count);
 
 // PDFs in DL channel resolved topology
-enum class PDF1_dl { b1, mw_onshell, count };
-enum class PDF2_dl { count };
+enum class PDF1_dl { b1, mw_onshell, nulep_deta, nulep_dphi, count };
+enum class PDF2_dl { b1_pt, count };
 inline constexpr size_t NUM_PDF_1D_DL = static_cast<size_t>(PDF1_dl::count);
 inline constexpr size_t NUM_PDF_2D_DL = static_cast<size_t>(PDF2_dl::count);
 
@@ -58,9 +61,18 @@ inline constexpr int N_BINS = 10000;
 inline constexpr Float_t MET_SIGMA = 25.2;
 inline constexpr Float_t DEFAULT_JET_RES = 0.1;
 
+// range of uniform sampling of neutrino direction from onshell W in DL channel
+inline constexpr Float_t MAX_NU_ETA = 6.0;
+inline constexpr Float_t MAX_NU_PHI = 3.1415926;
+
 inline constexpr unsigned Q16 = 16;
 inline constexpr unsigned Q84 = 84;
 
+// early stopping (-DEARLY_STOP): width is checked every EARLY_STOP_CHECK iterations
+// sampling stops when relative change of width is below EARLY_STOP_TOL
+inline constexpr int EARLY_STOP_CHECK = 100;
+inline constexpr Float_t EARLY_STOP_TOL = 0.01;
+
 inline constexpr size_t NUM_BEST_BTAG = 2;
 
 inline static const std::unordered_map<PDF1_sl, TString> pdf1d_sl_names = { { PDF1_sl::numet_pt, "pdf_numet_pt" },
@@ -77,11 +89,54 @@ inline static const std::unordered_map<PDF2_sl, TString> pdf2d_sl_names = { { PD
                                                                             { PDF2_sl::q1q2, "pdf_q1q2" },
                                                                             { PDF2_sl::mw1mw2, "pdf_mw1mw2" },
                                                                             { PDF2_sl::hh_dEtadPhi, "pdf_hh_dEtadPhi" },
-                                                                            { PDF2_sl::hh_pt_e, "pdf_hh_pt_e" } };
+                                                                            { PDF2_sl::hh_pt_e, "pdf_hh_pt_e" },
+                                                                            { PDF2_sl::b1_pt, "pdf_b1_pt" },
+                                                                            { PDF2_sl::q1_pt, "pdf_q1_pt" } };
 
 inline static const std::unordered_map<PDF1_dl, TString> pdf1d_dl_names = { { PDF1_dl::b1, "pdf_b1_run2" }, 
-                                                                            { PDF1_dl::mw_onshell, "pdf_mw_onshell" }};
+                                                                            { PDF1_dl::mw_onshell, "pdf_mw_onshell" },
+                                                                            { PDF1_dl::nulep_deta, "pdf_nulep_deta" },
+                                                                            { PDF1_dl::nulep_dphi, "pdf_nulep_dphi" } };
                                                                         
-inline static const std::unordered_map<PDF2_dl, TString> pdf2d_dl_names = {};
+inline static const std::unordered_map<PDF2_dl, TString> pdf2d_dl_names = { { PDF2_dl::b1_pt, "pdf_b1_pt" } };
+
+// jet rescaling PDFs conditioned on reco pt of the rescaled jet (-DCONDITIONAL_PDF): x is correction, y is jet pt
+// jets above MAX_COND_JET_PT use the last pt bin
+inline constexpr int N_COND_JET_PT_BINS = 16;
+inline constexpr Float_t MIN_COND_JET_PT = 20.0;
+inline constexpr Float_t MAX_COND_JET_PT = 500.0;
+
+// PDFs used by each estimation method: only these are read, validated and turned into samplers
+#ifdef CONDITIONAL_PDF
+inline static const std::unordered_map<Method, std::vector<PDF1_sl>> pdf1d_sl_required = { { Method::Eqns, {} },
+                                                                                          { Method::Weights, { PDF1_sl::numet_pt, PDF1_sl::numet_dphi, PDF1_sl::nulep_deta,
+                                                                                                               PDF1_sl::hh_dphi, PDF1_sl::mbb, PDF1_sl::mww } } };
+#else
+inline static const std::unordered_map<Method, std::vector<PDF1_sl>> pdf1d_sl_required = { { Method::Eqns, { PDF1_sl::b1, PDF1_sl::q1 } },
+                                                                                          { Method::Weights, { PDF1_sl::numet_pt, PDF1_sl::numet_dphi, PDF1_sl::nulep_deta,
+                                                                                                               PDF1_sl::hh_dphi, PDF1_sl::mbb, PDF1_sl::mww } } };
+#endif
+
+#ifdef CONDITIONAL_PDF
+inline static const std::unordered_map<Method, std::vector<PDF2_sl>> pdf2d_sl_required = { { Method::Eqns, { PDF2_sl::mw1mw2, PDF2_sl::b1_pt, PDF2_sl::q1_pt } },
+                                                                                          { Method::Weights, { PDF2_sl::b1b2 } } };
+#else
+inline static const std::unordered_map<Method, std::vector<PDF2_sl>> pdf2d_sl_required = { { Method::Eqns, { PDF2_sl::mw1mw2 } },
+                                                                                          { Method::Weights, { PDF2_sl::b1b2 } } };
+#endif
+
+// DL channel has only eqns method
+#ifdef CONDITIONAL_PDF
+inline static const std::unordered_map<Method, std::vector<PDF1_dl>> pdf1d_dl_required = { { Method::Eqns, { PDF1_dl::mw_onshell } } };
+
+inline static const std::unordered_map<Method, std::vector<PDF2_dl>> pdf2d_dl_required = { { Method::Eqns, { PDF2_dl::b1_pt } } };
+#else
+inline static const std::unordered_map<Method, std::vector<PDF1_dl>> pdf1d_dl_required = { { Method::Eqns, { PDF1_dl::b1, PDF1_dl::mw_onshell } } };
+
+inline static const std::unordered_map<Method, std::vector<PDF2_dl>> pdf2d_dl_required = { { Method::Eqns, {} } };
+#endif
+
+// proposal PDFs of neutrino direction in DL channel, required only with Sampling::Importance
+inline static const std::vector<PDF1_dl> pdf1d_dl_proposal = { PDF1_dl::nulep_deta, PDF1_dl::nulep_dphi };
 
 #endif
\ No newline at end of file
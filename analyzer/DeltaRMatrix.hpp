@@ -0,0 +1,115 @@
+#ifndef DELTA_R_MATRIX_HPP
+#define DELTA_R_MATRIX_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// dR^2 from direction (eta, phi) to n directions given by contiguous eta and phi arrays
+// phi is expected in [-pi, pi], |dphi| is wrapped with min(|dphi|, 2pi - |dphi|),
+// so loop has no branches and is vectorized (4 or 8 columns per instruction depending on target)
+inline void DeltaR2Row(float eta, float phi, float const* etas, float const* phis, int n, float* out)
+{
+    constexpr float TWO_PI = 6.28318530717958648f;
+    for (int j = 0; j < n; ++j)
+    {
+        float deta = etas[j] - eta;
+        float dphi = std::abs(phis[j] - phi);
+        dphi = std::min(dphi, TWO_PI - dphi);
+        out[j] = deta*deta + dphi*dphi;
+    }
+}
+
+// dR^2 between every row object (partons, leptons) and every column object (jets), stored row by row
+// objects are converted to separate eta and phi arrays once, rows are computed by DeltaR2Row
+// cones are compared in dR^2, square root is only taken when dR itself is needed
+// buffers are reused between calls, so one matrix per event loop avoids allocations
+class DeltaRMatrix
+{
+    public:
+    // Vec is any 4-vector with Eta() and Phi(), e.g. TLorentzVector or ROOT::Math::LorentzVector
+    template <typename RowVec, typename ColVec>
+    void Fill(std::vector<RowVec> const& rows, std::vector<ColVec> const& cols)
+    {
+        Load(rows, m_row_eta, m_row_phi);
+        Load(cols, m_col_eta, m_col_phi);
+        Compute(m_row_eta.data(), m_row_phi.data(), rows.size(), m_col_eta.data(), m_col_phi.data(), cols.size());
+    }
+
+    // single row
+    template <typename RowVec, typename ColVec>
+    void Fill(RowVec const& row, std::vector<ColVec> const& cols)
+    {
+        float eta = row.Eta();
+        float phi = row.Phi();
+        Load(cols, m_col_eta, m_col_phi);
+        Compute(&eta, &phi, 1, m_col_eta.data(), m_col_phi.data(), cols.size());
+    }
+
+    // directions already stored in contiguous arrays, e.g. NanoAOD branches
+    void Fill(float const* row_eta, float const* row_phi, int n_rows, float const* col_eta, float const* col_phi, int n_cols)
+    {
+        Compute(row_eta, row_phi, n_rows, col_eta, col_phi, n_cols);
+    }
+
+    inline int NumRows() const { return m_n_rows; }
+    inline int NumCols() const { return m_n_cols; }
+    inline float const* Row(int row) const { return m_dr2.data() + static_cast<size_t>(row)*m_n_cols; }
+    inline float DR2(int row, int col) const { return Row(row)[col]; }
+    inline double DR(int row, int col) const { return std::sqrt(DR2(row, col)); }
+
+    // index of column closest to row, the first one in case of ties, -1 if there are no columns
+    int ClosestCol(int row) const
+    {
+        float const* dr2 = Row(row);
+        return m_n_cols > 0 ? std::min_element(dr2, dr2 + m_n_cols) - dr2 : -1;
+    }
+
+    // number of columns with dR < max_dr to row
+    int CountWithin(int row, double max_dr) const
+    {
+        float const* dr2 = Row(row);
+        float max_dr2 = max_dr*max_dr;
+        int count = 0;
+        for (int j = 0; j < m_n_cols; ++j)
+        {
+            count += dr2[j] < max_dr2;
+        }
+        return count;
+    }
+
+    private:
+    template <typename Vec>
+    static void Load(std::vector<Vec> const& objects, std::vector<float>& eta, std::vector<float>& phi)
+    {
+        size_t n = objects.size();
+        eta.resize(n);
+        phi.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            eta[i] = objects[i].Eta();
+            phi[i] = objects[i].Phi();
+        }
+    }
+
+    void Compute(float const* row_eta, float const* row_phi, int n_rows, float const* col_eta, float const* col_phi, int n_cols)
+    {
+        m_n_rows = n_rows;
+        m_n_cols = n_cols;
+        m_dr2.resize(static_cast<size_t>(n_rows)*n_cols);
+        for (int i = 0; i < n_rows; ++i)
+        {
+            DeltaR2Row(row_eta[i], row_phi[i], col_eta, col_phi, n_cols, m_dr2.data() + static_cast<size_t>(i)*n_cols);
+        }
+    }
+
+    int m_n_rows = 0;
+    int m_n_cols = 0;
+    std::vector<float> m_row_eta;
+    std::vector<float> m_row_phi;
+    std::vector<float> m_col_eta;
+    std::vector<float> m_col_phi;
+    std::vector<float> m_dr2;
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include <unordered_set>
 
 #include "TVector2.h"
+#include "FastMath.hpp"
 #include "Math/GenVector/VectorUtil.h" // DeltaPhi
 using ROOT::Math::VectorUtil::DeltaPhi;
 
@@ -24,18 +25,135 @@ using ROOT::Math::VectorUtil::DeltaPhi;
 EstimatorBase::EstimatorBase() 
 :   m_prg(std::make_unique<TRandom3>(SEED))
 ,   m_res_mass(std::make_unique<TH1F>("none", "none", N_BINS, MIN_MASS, MAX_MASS))
+,   m_q16(Q16/100.0)
+,   m_q50(0.5)
+,   m_q84(Q84/100.0)
 {}
 
+namespace
+{
+    // width of mass distribution of a combination is at least one bin of mass histogram,
+    // combination with all accepted masses in one bin must not get infinite weight in the choice metric
+    inline constexpr Float_t MIN_COMB_WIDTH = (MAX_MASS - MIN_MASS)/N_BINS;
+
+    inline Float_t InvWidth(Float_t width)
+    {
+        return 1.0/std::max(width, MIN_COMB_WIDTH);
+    }
+
+    template <typename T>
+    std::unique_ptr<TH1> ReadPDF(TFile* file, TString const& name)
+    {
+        std::unique_ptr<TH1> pdf(file->Get<T>(name));
+        if (!pdf)
+        {
+            throw std::runtime_error("LoadPDFs: PDF " + std::string(name.Data()) + " is missing in " + std::string(file->GetName()));
+        }
+        pdf->SetDirectory(nullptr);
+        return pdf;
+    }
+
+    template <typename PDF1, typename PDF2>
+    void LoadRequiredPDFs(TString const& pdf_file_name,
+                          std::unordered_map<PDF1, TString> const& names_1d,
+                          std::unordered_map<PDF2, TString> const& names_2d,
+                          std::vector<PDF1> const& required_1d,
+                          std::vector<PDF2> const& required_2d,
+                          PDFBundle& bundle,
+                          std::vector<PDF1DView>& pdf_1d,
+                          std::vector<PDF2DView>& pdf_2d)
+    {
+        if (pdf_file_name.EndsWith(".bundle"))
+        {
+            // pages of PDFs which are not required are never touched
+            bundle = PDFBundle::Open(pdf_file_name);
+        }
+        else
+        {
+            TFile* pf = TFile::Open(pdf_file_name);
+            if (!pf || pf->IsZombie())
+            {
+                throw std::runtime_error("LoadPDFs: unable to open " + std::string(pdf_file_name.Data()));
+            }
+
+            std::vector<std::unique_ptr<TH1>> hists;
+            for (auto pdf: required_1d)
+            {
+                hists.push_back(ReadPDF<TH1F>(pf, names_1d.at(pdf)));
+            }
+            for (auto pdf: required_2d)
+            {
+                hists.push_back(ReadPDF<TH2F>(pf, names_2d.at(pdf)));
+            }
+            pf->Close();
+
+            std::vector<TH1 const*> hist_ptrs;
+            for (auto const& hist: hists)
+            {
+                hist_ptrs.push_back(hist.get());
+            }
+            bundle = PDFBundle::FromHists(hist_ptrs);
+        }
+
+        pdf_1d.assign(names_1d.size(), PDF1DView{});
+        for (auto pdf: required_1d)
+        {
+            TString const& name = names_1d.at(pdf);
+            pdf_1d[static_cast<size_t>(pdf)] = bundle.Get1D(name);
+            if (pdf_1d[static_cast<size_t>(pdf)].IsEmpty())
+            {
+                throw std::runtime_error("LoadPDFs: PDF " + std::string(name.Data()) + " is empty");
+            }
+        }
+
+        pdf_2d.assign(names_2d.size(), PDF2DView{});
+        for (auto pdf: required_2d)
+        {
+            TString const& name = names_2d.at(pdf);
+            pdf_2d[static_cast<size_t>(pdf)] = bundle.Get2D(name);
+            if (pdf_2d[static_cast<size_t>(pdf)].IsEmpty())
+            {
+                throw std::runtime_error("LoadPDFs: PDF " + std::string(name.Data()) + " is empty");
+            }
+        }
+    }
+}
+
+void EstimatorBase::LoadPDFs(TString const& pdf_file_name, Channel ch, Method method, Sampling sampling)
+{
+    m_method = method;
+    if (ch == Channel::SL)
+    {
+        LoadRequiredPDFs(pdf_file_name, pdf1d_sl_names, pdf2d_sl_names, pdf1d_sl_required.at(method), pdf2d_sl_required.at(method), 
+                         m_pdfs, m_pdf_1d, m_pdf_2d);
+    }
+    else if (ch == Channel::DL)
+    {
+        std::vector<PDF1_dl> required_1d = pdf1d_dl_required.at(method);
+        if (sampling == Sampling::Importance)
+        {
+            required_1d.insert(required_1d.end(), pdf1d_dl_proposal.begin(), pdf1d_dl_proposal.end());
+        }
+        LoadRequiredPDFs(pdf_file_name, pdf1d_dl_names, pdf2d_dl_names, required_1d, pdf2d_dl_required.at(method), 
+                         m_pdfs, m_pdf_1d, m_pdf_2d);
+    }
+    else 
+    {
+        throw std::runtime_error("LoadPDFs: attempting to read PDFs for unnkown channel");
+    }
+}
+
 
-EstimatorSingleLep::EstimatorSingleLep(TString const& pdf_file_name)
+EstimatorSingleLep::EstimatorSingleLep(TString const& pdf_file_name, Method method)
 {
-    m_pdf_1d.resize(pdf1d_sl_names.size());
-    m_pdf_2d.resize(pdf2d_sl_names.size());
+    LoadPDFs(pdf_file_name, Channel::SL, method);
 
-    TFile* pf = TFile::Open(pdf_file_name);
-    Get1dPDFs(pf, m_pdf_1d, Channel::SL);
-    Get2dPDFs(pf, m_pdf_2d, Channel::SL);
-    pf->Close();
+    if (method == Method::Weights)
+    {
+        m_table_mbb = PDFTable1D(m_pdf_1d[static_cast<size_t>(PDF1_sl::mbb)]);
+        m_table_mww = PDFTable1D(m_pdf_1d[static_cast<size_t>(PDF1_sl::mww)]);
+        m_table_hh_dphi = PDFTable1D(m_pdf_1d[static_cast<size_t>(PDF1_sl::hh_dphi)]);
+    }
 }
 
 
@@ -44,8 +162,102 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaWeights(VecL
                                                                             ULong64_t evt, 
                                                                             TString const& comb_id)
 {
-    // TODO
-    return {};
+    std::array<Float_t, OUTPUT_SIZE> res = {-1.0};
+
+    LorentzVectorF_t const& bj1 = particles[static_cast<size_t>(ObjSL::bj1)];
+    LorentzVectorF_t const& bj2 = particles[static_cast<size_t>(ObjSL::bj2)];
+    LorentzVectorF_t const& lj1 = particles[static_cast<size_t>(ObjSL::lj1)];
+    LorentzVectorF_t const& lj2 = particles[static_cast<size_t>(ObjSL::lj2)];
+    LorentzVectorF_t const& lep = particles[static_cast<size_t>(ObjSL::lep)];
+    LorentzVectorF_t const& met = particles[static_cast<size_t>(ObjSL::met)];
+
+    PDF1DView const& pdf_numet_pt = m_pdf_1d[static_cast<size_t>(PDF1_sl::numet_pt)];
+    PDF1DView const& pdf_numet_dphi = m_pdf_1d[static_cast<size_t>(PDF1_sl::numet_dphi)];
+    PDF1DView const& pdf_nulep_deta = m_pdf_1d[static_cast<size_t>(PDF1_sl::nulep_deta)];
+    PDF2DView const& pdf_b1b2 = m_pdf_2d[static_cast<size_t>(PDF2_sl::b1b2)];
+
+    Float_t mh = m_prg->Gaus(HIGGS_MASS, HIGGS_WIDTH);
+    auto [res1, res2] = lj_pt_res;
+
+    m_res_mass->SetNameTitle("X_mass", Form("X->HH mass: event %llu, comb %s", evt, comb_id.Data()));
+
+    // first pass: sample all iterations and store kinematics needed for weights
+    std::array<Float_t, N_ITER> hbb_mass;
+    std::array<Float_t, N_ITER> hww_mass;
+    std::array<Float_t, N_ITER> hh_dphi;
+    std::array<Float_t, N_ITER> x_mass;
+    std::array<Float_t, N_ITER> weights;
+    for (int i = 0; i < N_ITER; ++i)
+    {
+        LorentzVectorF_t j1 = SamplePNetResCorr(lj1, m_prg, res1);
+        LorentzVectorF_t j2 = SamplePNetResCorr(lj2, m_prg, res2);
+
+        Float_t eta = lep.Eta() + Draw(pdf_nulep_deta);
+        Float_t dphi = Draw(pdf_numet_dphi);
+        Float_t met_fraction = Draw(pdf_numet_pt);
+
+        Double_t c1 = 1.0;
+        Double_t c2 = 1.0;
+        pdf_b1b2.Sample(c1, c2, m_prg.get());
+
+        LorentzVectorF_t b1 = bj1;
+        LorentzVectorF_t b2 = bj2;
+        b1 *= c1;
+        b2 *= c2;
+
+        Float_t smear_dpx = m_prg->Gaus(0.0, MET_SIGMA);
+        Float_t smear_dpy = m_prg->Gaus(0.0, MET_SIGMA);
+
+        Float_t met_corr_px = met.Px() - (c1 - 1)*bj1.Px() - (c2 - 1)*bj2.Px() - (j1.Px() - lj1.Px()) - (j2.Px() - lj2.Px()) + smear_dpx;
+        Float_t met_corr_py = met.Py() - (c1 - 1)*bj1.Py() - (c2 - 1)*bj2.Py() - (j1.Py() - lj1.Py()) - (j2.Py() - lj2.Py()) + smear_dpy;
+
+        Float_t met_corr_pt = std::sqrt(met_corr_px*met_corr_px + met_corr_py*met_corr_py);
+        Float_t met_corr_phi = hme_math::Atan2(met_corr_py, met_corr_px);
+
+        LorentzVectorF_t nu(met_fraction*met_corr_pt, eta, hme_math::Phi_mpi_pi(met_corr_phi + dphi), 0.0);
+
+        LorentzVectorF_t hbb = b1;
+        hbb += b2;
+
+        LorentzVectorF_t hww = lep;
+        hww += nu;
+        hww += j1;
+        hww += j2;
+
+        hbb_mass[i] = hbb.M();
+        hww_mass[i] = hww.M();
+        hh_dphi[i] = DeltaPhi(hbb, hww);
+        x_mass[i] = (hbb + hww).M();
+        weights[i] = x_mass[i] < 2.0*mh ? 0.0f : 1.0f;
+    }
+
+    // second pass: likelihood of each sample from lookup tables
+    m_table_mbb.MultiplyDensity(hbb_mass.data(), weights.data(), N_ITER);
+    m_table_mww.MultiplyDensity(hww_mass.data(), weights.data(), N_ITER);
+    m_table_hh_dphi.MultiplyDensity(hh_dphi.data(), weights.data(), N_ITER);
+
+    m_n_iter += N_ITER;
+    for (int i = 0; i < N_ITER; ++i)
+    {
+        if (weights[i] > 0.0f)
+        {
+            ++m_n_accepted;
+            m_res_mass->Fill(x_mass[i], weights[i]);
+        }
+    }
+
+    Float_t integral = m_res_mass->Integral();
+    if (m_res_mass->GetEntries() && integral > 0.0)
+    {
+        int binmax = m_res_mass->GetMaximumBin(); 
+        res[static_cast<size_t>(Output::mass)] = m_res_mass->GetXaxis()->GetBinCenter(binmax);
+        res[static_cast<size_t>(Output::peak_val)] = m_res_mass->GetBinContent(binmax);
+        res[static_cast<size_t>(Output::width)] = ComputeWidth(m_res_mass, Q16, Q84);
+        res[static_cast<size_t>(Output::integral)] = integral;
+        return res;
+    }
+
+    return res;
 }
 
 std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_t const& particles, 
@@ -61,9 +273,14 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
     LorentzVectorF_t const& lep = particles[static_cast<size_t>(ObjSL::lep)];
     LorentzVectorF_t const& met = particles[static_cast<size_t>(ObjSL::met)];
 
-    UHist_t<TH1F>& pdf_b1 = m_pdf_1d[static_cast<size_t>(PDF1_sl::b1)];
-    UHist_t<TH1F>& pdf_q1 = m_pdf_1d[static_cast<size_t>(PDF1_sl::q1)];
-    UHist_t<TH2F>& pdf_mw1mw2 = m_pdf_2d[static_cast<size_t>(PDF2_sl::mw1mw2)];
+    #ifdef CONDITIONAL_PDF
+        PDF2DView const& pdf_b1 = m_pdf_2d[static_cast<size_t>(PDF2_sl::b1_pt)];
+        PDF2DView const& pdf_q1 = m_pdf_2d[static_cast<size_t>(PDF2_sl::q1_pt)];
+    #else
+        PDF1DView const& pdf_b1 = m_pdf_1d[static_cast<size_t>(PDF1_sl::b1)];
+        PDF1DView const& pdf_q1 = m_pdf_1d[static_cast<size_t>(PDF1_sl::q1)];
+    #endif
+    PDF2DView const& pdf_mw1mw2 = m_pdf_2d[static_cast<size_t>(PDF2_sl::mw1mw2)];
 
     Float_t mh = m_prg->Gaus(HIGGS_MASS, HIGGS_WIDTH);
     m_res_mass->SetNameTitle("X_mass", Form("X->HH mass: event %llu, comb %s", evt, comb_id.Data()));
@@ -77,16 +294,41 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
         hists[i] = std::make_unique<TH1F>(hist_names[i], hist_title, 100, MIN_MASS, MAX_MASS);
     }
 
+    ResetQuantiles();
+    [[maybe_unused]] Float_t prev_width = -1.0;
+
+    ULong64_t n_iter_before = m_n_iter;
+    ULong64_t n_accepted_before = m_n_accepted;
     [[maybe_unused]] int failed_iter = 0;
+    StartPeakTrace();
     for (int i = 0; i < N_ITER; ++i)
     {
+        RecordPeak(i);
+
+        #ifdef EARLY_STOP
+            // stop sampling once width of mass distribution is stable
+            if (i > 0 && i % EARLY_STOP_CHECK == 0 && m_q50.Count() >= EARLY_STOP_CHECK)
+            {
+                Float_t width = m_q84.Get() - m_q16.Get();
+                if (prev_width > 0.0 && std::abs(width - prev_width) < EARLY_STOP_TOL*prev_width)
+                {
+                    break;
+                }
+                prev_width = width;
+            }
+        #endif
+
+        ++m_n_iter;
+
         Float_t smear_dpx = m_prg->Gaus(0.0, MET_SIGMA);
         Float_t smear_dpy = m_prg->Gaus(0.0, MET_SIGMA);
 
         auto bresc = ComputeJetResc(bj1, bj2, pdf_b1, mh);
+        ++m_n_resc;
         if (!bresc.has_value())
         {
             ++failed_iter;
+            ++m_n_resc_failed;
             continue;
         }
         auto [c1, c2] = bresc.value();
@@ -98,7 +340,7 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
 
         Double_t mw1 = 1.0;
         Double_t mw2 = 1.0;
-        pdf_mw1mw2->GetRandom2(mw1, mw2, m_prg.get());
+        pdf_mw1mw2.Sample(mw1, mw2, m_prg.get());
 
         std::vector<Float_t> masses;
         std::vector<Float_t> hww_dm;
@@ -114,9 +356,11 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
             LorentzVectorF_t j1 = lj1.Pt() > lj2.Pt() ? lj1 : lj2;
             LorentzVectorF_t j2 = lj1.Pt() > lj2.Pt() ? lj2 : lj1;
             auto lresc = ComputeJetResc(j1, j2, pdf_q1, mWhad);
+            ++m_n_resc;
             if (!lresc.has_value())
             {
                 ++failed_iter;
+                ++m_n_resc_failed;
                 continue;
             }
             auto [c3, c4] = lresc.value();
@@ -134,7 +378,7 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
             Float_t met_corr_py = met.Py() + bjet_resc_dpy + ljet_resc_dpy + smear_dpy;
 
             Float_t met_corr_pt = std::sqrt(met_corr_px*met_corr_px + met_corr_py*met_corr_py);
-            Float_t met_corr_phi = std::atan2(met_corr_py, met_corr_px);
+            Float_t met_corr_phi = hme_math::Atan2(met_corr_py, met_corr_px);
             LorentzVectorF_t met_corr(met_corr_pt, 0.0, met_corr_phi, 0.0);
 
             auto nu = NuFromW(lep, met_corr, add_deta, mWlep);
@@ -165,15 +409,19 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
             ++failed_iter;
             continue;
         }
+        ++m_n_accepted;
 
         // auto it = std::min_element(hww_dm.begin(), hww_dm.end());
         // size_t idx = it - hww_dm.begin();
         // m_res_mass->Fill(masses[idx]);
 
+        // every accepted iteration has total weight 1, shared between its solutions,
+        // quantiles use the same weights as the mass histogram
         Float_t weight = 1.0/masses.size();
         for (auto mass: masses)
         {
             m_res_mass->Fill(mass, weight);
+            AddToQuantiles(mass, weight);
         }
 
         // size_t choice = 0;
@@ -195,6 +443,8 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
         // }
         // m_res_mass->Fill(masses[choice]);
     }
+    RecordPeak(N_ITER);
+    AddCombAcceptance(m_n_iter - n_iter_before, m_n_accepted - n_accepted_before);
 
     #ifdef PLOT
         for (int i = 0; i < 4; ++i)
@@ -233,7 +483,7 @@ std::array<Float_t, OUTPUT_SIZE> EstimatorSingleLep::EstimateCombViaEqns(VecLVF_
         int binmax = m_res_mass->GetMaximumBin(); 
         res[static_cast<size_t>(Output::mass)] = m_res_mass->GetXaxis()->GetBinCenter(binmax);
         res[static_cast<size_t>(Output::peak_val)] = m_res_mass->GetBinContent(binmax);
-        res[static_cast<size_t>(Output::width)] = ComputeWidth(m_res_mass, Q16, Q84);
+        res[static_cast<size_t>(Output::width)] = m_q84.Get() - m_q16.Get();
         res[static_cast<size_t>(Output::integral)] = integral;
         return res;
     }
@@ -248,8 +498,11 @@ std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets,
                                                         ULong64_t evt, 
                                                         TString& chosen_comb)
 {
-    // TODO
-    return std::nullopt;
+    if (m_method != Method::Weights)
+    {
+        throw std::runtime_error("EstimatorSingleLep: PDFs were loaded for eqns method, weights method requested");
+    }
+    return EstimateMassImpl(jets, leptons, &jet_resolutions, met, evt, chosen_comb);
 }
 
 std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets, 
@@ -257,6 +510,21 @@ std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets,
                                                         LorentzVectorF_t const& met, 
                                                         ULong64_t evt, 
                                                         TString& chosen_comb)
+{
+    if (m_method != Method::Eqns)
+    {
+        throw std::runtime_error("EstimatorSingleLep: PDFs were loaded for weights method, eqns method requested");
+    }
+    return EstimateMassImpl(jets, leptons, nullptr, met, evt, chosen_comb);
+}
+
+// with jet resolutions combinations are estimated via weights, otherwise via equations
+std::optional<Float_t> EstimatorSingleLep::EstimateMassImpl(VecLVF_t const& jets, 
+                                                            VecLVF_t const& leptons, 
+                                                            std::vector<Float_t> const* jet_resolutions, 
+                                                            LorentzVectorF_t const& met, 
+                                                            ULong64_t evt, 
+                                                            TString& chosen_comb)
 {
     VecLVF_t particles(static_cast<size_t>(ObjSL::count));
     particles[static_cast<size_t>(ObjSL::lep)] = leptons[static_cast<size_t>(Lep::lep1)];
@@ -266,6 +534,7 @@ std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets,
     [[maybe_unused]] std::vector<Float_t> integrals;
     std::vector<Float_t> inv_widths;
     [[maybe_unused]] std::vector<Float_t> peaks;
+    std::vector<TString> labels;
 
     std::unordered_set<size_t> used;
     for (size_t bj1_idx = 0; bj1_idx < NUM_BEST_BTAG; ++bj1_idx)
@@ -301,27 +570,31 @@ std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets,
                     }
                     used.insert(lj2_idx);
 
-                    if (jets[lj1_idx].Pt() > jets[lj2_idx].Pt())
+                    size_t lead_idx = jets[lj1_idx].Pt() > jets[lj2_idx].Pt() ? lj1_idx : lj2_idx;
+                    size_t sublead_idx = lead_idx == lj1_idx ? lj2_idx : lj1_idx;
+                    particles[static_cast<size_t>(ObjSL::lj1)] = jets[lead_idx];
+                    particles[static_cast<size_t>(ObjSL::lj2)] = jets[sublead_idx];
+
+                    TString comb_label = Form("b%zub%zuq%zuq%zu", bj1_idx, bj2_idx, lj1_idx, lj2_idx);
+                    std::array<Float_t, OUTPUT_SIZE> comb_result;
+                    if (jet_resolutions)
                     {
-                        particles[static_cast<size_t>(ObjSL::lj1)] = jets[lj1_idx];
-                        particles[static_cast<size_t>(ObjSL::lj2)] = jets[lj2_idx];
+                        std::pair<Float_t, Float_t> lj_res = {(*jet_resolutions)[lead_idx], (*jet_resolutions)[sublead_idx]};
+                        comb_result = EstimateCombViaWeights(particles, lj_res, evt, comb_label);
                     }
                     else 
                     {
-                        particles[static_cast<size_t>(ObjSL::lj1)] = jets[lj2_idx];
-                        particles[static_cast<size_t>(ObjSL::lj2)] = jets[lj1_idx];
+                        comb_result = EstimateCombViaEqns(particles, evt, comb_label);
                     }
 
-                    TString comb_label = Form("b%zub%zuq%zuq%zu", bj1_idx, bj2_idx, lj1_idx, lj2_idx);
-                    auto comb_result = EstimateCombViaEqns(particles, evt, comb_label);
-
                     if (comb_result[static_cast<size_t>(Output::mass)] > 0.0)
                     {
                         estimations.push_back(comb_result[static_cast<size_t>(Output::mass)]);
 
                         integrals.push_back(comb_result[static_cast<size_t>(Output::integral)]);
-                        inv_widths.push_back(1.0/comb_result[static_cast<size_t>(Output::width)]);
+                        inv_widths.push_back(InvWidth(comb_result[static_cast<size_t>(Output::width)]));
                         peaks.push_back(comb_result[static_cast<size_t>(Output::peak_val)]);
+                        labels.push_back(comb_label);
                     }
                     Reset(m_res_mass);
                     used.erase(lj2_idx);
@@ -333,13 +606,6 @@ std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets,
         used.erase(bj1_idx);
     }
 
-    // if (!estimations.empty())
-    // {
-    //     auto it = std::max_element(inv_widths.begin(), inv_widths.end());
-    //     int idx = it - inv_widths.begin();
-    //     return std::make_optional<Float_t>(estimations[idx]);
-    // }
-
     if (!estimations.empty())
     {
         size_t choice = 0;
@@ -360,6 +626,7 @@ std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets,
                 }
             }
         }
+        chosen_comb = labels[choice];
         return std::make_optional<Float_t>(estimations[choice]);
     }
 
@@ -367,61 +634,407 @@ std::optional<Float_t> EstimatorSingleLep::EstimateMass(VecLVF_t const& jets,
 }
 
 
-EstimatorDoubleLep::EstimatorDoubleLep(TString const& pdf_file_name)
+EstimatorDoubleLep::EstimatorDoubleLep(TString const& pdf_file_name, Method method, Sampling sampling)
+:   m_sampling(sampling)
 {
-    m_pdf_1d.resize(pdf1d_dl_names.size());
-    m_pdf_2d.resize(pdf2d_dl_names.size());
-    
-    TFile* pf = TFile::Open(pdf_file_name);
-    Get1dPDFs(pf, m_pdf_1d, Channel::DL);
-    Get2dPDFs(pf, m_pdf_2d, Channel::DL);
-    pf->Close();
+    if (method != Method::Eqns)
+    {
+        throw std::runtime_error("EstimatorDoubleLep: weights method is not implemented in DL channel, use eqns");
+    }
+    LoadPDFs(pdf_file_name, Channel::DL, method, sampling);
+    if (m_sampling == Sampling::Importance)
+    {
+        SetSampling(Sampling::Importance);
+    }
 }
 
+void EstimatorDoubleLep::SetSampling(Sampling sampling)
+{
+    if (sampling == Sampling::Importance)
+    {
+        // PDFs are stored normalized to maximum; proposal weights need normalization to unit area
+        PDF1DView const& pdf_nulep_deta = m_pdf_1d[static_cast<size_t>(PDF1_dl::nulep_deta)];
+        PDF1DView const& pdf_nulep_dphi = m_pdf_1d[static_cast<size_t>(PDF1_dl::nulep_dphi)];
+        m_nulep_deta_norm = pdf_nulep_deta.IsEmpty() ? 0.0 : pdf_nulep_deta.IntegralWidth();
+        m_nulep_dphi_norm = pdf_nulep_dphi.IsEmpty() ? 0.0 : pdf_nulep_dphi.IntegralWidth();
+        if (m_nulep_deta_norm <= 0.0 || m_nulep_dphi_norm <= 0.0)
+        {
+            throw std::runtime_error("EstimatorDoubleLep: importance sampling requires non-empty pdf_nulep_deta and pdf_nulep_dphi");
+        }
+    }
+    m_sampling = sampling;
+}
 
-std::array<Float_t, OUTPUT_SIZE> EstimatorDoubleLep::EstimateCombViaWeights(VecLVF_t const& particles, 
-                                                                            std::pair<Float_t, Float_t> lj_pt_res, 
-                                                                            ULong64_t evt, 
-                                                                            TString const& comb_id)
+
+// there are no PDFs of HH kinematics in DL channel to weight samples with
+std::array<Float_t, OUTPUT_SIZE> EstimatorDoubleLep::EstimateCombViaWeights([[maybe_unused]] VecLVF_t const& particles, 
+                                                                            [[maybe_unused]] std::pair<Float_t, Float_t> lj_pt_res, 
+                                                                            [[maybe_unused]] ULong64_t evt, 
+                                                                            [[maybe_unused]] TString const& comb_id)
 {
-    // TODO
-    return {};
+    throw std::runtime_error("EstimatorDoubleLep: weights method is not implemented in DL channel");
 }
 
 std::array<Float_t, OUTPUT_SIZE> EstimatorDoubleLep::EstimateCombViaEqns(VecLVF_t const& particles, 
                                                                          ULong64_t evt, 
                                                                          TString const& comb_id)
 {
-    // TODO
-    return {};
+    std::array<Float_t, OUTPUT_SIZE> res = {-1.0};
+
+    LorentzVectorF_t const& bj1 = particles[static_cast<size_t>(ObjDL::bj1)];
+    LorentzVectorF_t const& bj2 = particles[static_cast<size_t>(ObjDL::bj2)];
+    LorentzVectorF_t const& lep1 = particles[static_cast<size_t>(ObjDL::lep1)];
+    LorentzVectorF_t const& lep2 = particles[static_cast<size_t>(ObjDL::lep2)];
+    LorentzVectorF_t const& met = particles[static_cast<size_t>(ObjDL::met)];
+
+    #ifdef CONDITIONAL_PDF
+        PDF2DView const& pdf_b1 = m_pdf_2d[static_cast<size_t>(PDF2_dl::b1_pt)];
+    #else
+        PDF1DView const& pdf_b1 = m_pdf_1d[static_cast<size_t>(PDF1_dl::b1)];
+    #endif
+    PDF1DView const& pdf_mw_onshell = m_pdf_1d[static_cast<size_t>(PDF1_dl::mw_onshell)];
+    PDF1DView const& pdf_nulep_deta = m_pdf_1d[static_cast<size_t>(PDF1_dl::nulep_deta)];
+    PDF1DView const& pdf_nulep_dphi = m_pdf_1d[static_cast<size_t>(PDF1_dl::nulep_dphi)];
+
+    // density of uniform sampling of (eta, phi) of neutrino from onshell W
+    constexpr Float_t uniform_density = 1.0/(4.0*MAX_NU_ETA*MAX_NU_PHI);
+
+    m_res_mass->SetNameTitle("X_mass", Form("X->HH mass: event %llu, comb %s", evt, comb_id.Data()));
+
+    ResetQuantiles();
+    [[maybe_unused]] Float_t prev_width = -1.0;
+
+    ULong64_t n_iter_before = m_n_iter;
+    ULong64_t n_accepted_before = m_n_accepted;
+    [[maybe_unused]] int failed_iter = 0;
+    StartPeakTrace();
+    for (int i = 0; i < N_ITER; ++i)
+    {
+        RecordPeak(i);
+
+        #ifdef EARLY_STOP
+            // stop sampling once width of mass distribution is stable
+            if (i > 0 && i % EARLY_STOP_CHECK == 0 && m_q50.Count() >= EARLY_STOP_CHECK)
+            {
+                Float_t width = m_q84.Get() - m_q16.Get();
+                if (prev_width > 0.0 && std::abs(width - prev_width) < EARLY_STOP_TOL*prev_width)
+                {
+                    break;
+                }
+                prev_width = width;
+            }
+        #endif
+
+        ++m_n_iter;
+
+        // uniform: (eta, phi) of neutrino are sampled directly
+        // importance: (deta, dphi) w.r.t. lepton from onshell W are sampled from learned PDFs 
+        // and each solution is weighted by ratio of uniform and proposal densities
+        Float_t eta_gen = 0.0;
+        Float_t phi_gen = 0.0;
+        Float_t nulep_deta = 0.0;
+        Float_t nulep_dphi = 0.0;
+        Float_t proposal_weight = 1.0;
+        if (m_sampling == Sampling::Importance)
+        {
+            nulep_deta = Draw(pdf_nulep_deta);
+            nulep_dphi = Draw(pdf_nulep_dphi);
+            Float_t q_deta = DrawDensity(pdf_nulep_deta, nulep_deta, m_nulep_deta_norm);
+            Float_t q_dphi = DrawDensity(pdf_nulep_dphi, nulep_dphi, m_nulep_dphi_norm);
+            // a draw from an empty proposal bin (edge of the bin) has no finite weight
+            if (!(q_deta*q_dphi > 0.0))
+            {
+                ++failed_iter;
+                continue;
+            }
+            proposal_weight = uniform_density/(q_deta*q_dphi);
+        }
+        else 
+        {
+            eta_gen = m_prg->Uniform(-MAX_NU_ETA, MAX_NU_ETA);
+            phi_gen = m_prg->Uniform(-MAX_NU_PHI, MAX_NU_PHI);
+        }
+
+        Float_t mh = m_prg->Gaus(HIGGS_MASS, HIGGS_WIDTH);
+        Float_t mw = Draw(pdf_mw_onshell);
+        Float_t smear_dpx = m_prg->Gaus(0.0, MET_SIGMA);
+        Float_t smear_dpy = m_prg->Gaus(0.0, MET_SIGMA);
+
+        auto bresc = ComputeJetResc(bj1, bj2, pdf_b1, mh);
+        ++m_n_resc;
+        if (!bresc.has_value())
+        {
+            ++failed_iter;
+            ++m_n_resc_failed;
+            continue;
+        }
+        auto [c1, c2] = bresc.value();
+
+        LorentzVectorF_t b1 = bj1;
+        LorentzVectorF_t b2 = bj2;
+        b1 *= c1;
+        b2 *= c2;
+
+        Float_t bjet_resc_dpx = -1.0*(c1 - 1)*bj1.Px() - (c2 - 1)*bj2.Px();
+        Float_t bjet_resc_dpy = -1.0*(c1 - 1)*bj1.Py() - (c2 - 1)*bj2.Py();
+
+        Float_t met_corr_px = met.Px() + bjet_resc_dpx + smear_dpx;
+        Float_t met_corr_py = met.Py() + bjet_resc_dpy + smear_dpy;
+
+        Float_t met_corr_pt = std::sqrt(met_corr_px*met_corr_px + met_corr_py*met_corr_py);
+        Float_t met_corr_phi = hme_math::Atan2(met_corr_py, met_corr_px);
+        LorentzVectorF_t met_corr(met_corr_pt, 0.0, met_corr_phi, 0.0);
+
+        LorentzVectorF_t hbb = b1;
+        hbb += b2;
+
+        // control / 2: which lepton comes from onshell W
+        // control % 2: sign of the solution for the neutrino from offshell W
+        // each lepton hypothesis is a sample of its own (eta, phi) point (different points in importance mode),
+        // so its weight is shared only between sign solutions of that hypothesis
+        std::vector<Float_t> masses;
+        std::vector<Float_t> weights;
+        std::vector<int> hypotheses;
+        std::array<int, 2> n_solutions = {0, 0};
+        for (int control = 0; control < 4; ++control)
+        {
+            int lep2_onshell = control / 2;
+            bool is_offshell = control % 2;
+
+            LorentzVectorF_t const& l_onshell = lep2_onshell ? lep2 : lep1;
+            LorentzVectorF_t const& l_offshell = lep2_onshell ? lep1 : lep2;
+
+            if (m_sampling == Sampling::Importance)
+            {
+                eta_gen = l_onshell.Eta() + nulep_deta;
+                phi_gen = hme_math::Phi_mpi_pi(l_onshell.Phi() + nulep_dphi);
+                // outside of support of uniform sampling
+                if (std::abs(eta_gen) > MAX_NU_ETA)
+                {
+                    continue;
+                }
+            }
+
+            auto nu_onshell = NuFromOnshellW(eta_gen, phi_gen, mw, l_onshell);
+            if (!nu_onshell)
+            {
+                continue;
+            }
+
+            auto nu_offshell = NuFromOffshellW(lep1, lep2, nu_onshell.value(), met_corr, is_offshell, mh);
+            if (!nu_offshell)
+            {
+                continue;
+            }
+
+            LorentzVectorF_t onshellW = l_onshell + nu_onshell.value();
+            LorentzVectorF_t offshellW = l_offshell + nu_offshell.value();
+            LorentzVectorF_t hww = onshellW + offshellW;
+
+            if (offshellW.M() > mh/2)
+            {
+                continue;
+            }
+
+            if (std::abs(hww.M() - mh) > 1.0)
+            {
+                continue;
+            }
+
+            Float_t mass = (hww + hbb).M();
+            if (mass > 0.0)
+            {
+                masses.push_back(mass);
+                weights.push_back(proposal_weight);
+                hypotheses.push_back(lep2_onshell);
+                ++n_solutions[lep2_onshell];
+            }
+        }
+
+        if (masses.empty())
+        {
+            ++failed_iter;
+            continue;
+        }
+        ++m_n_accepted;
+
+        // quantiles use the same weights as the mass histogram
+        for (size_t k = 0; k < masses.size(); ++k)
+        {
+            Float_t weight = weights[k]/n_solutions[hypotheses[k]];
+            m_res_mass->Fill(masses[k], weight);
+            AddToQuantiles(masses[k], weight);
+        }
+    }
+    RecordPeak(N_ITER);
+    AddCombAcceptance(m_n_iter - n_iter_before, m_n_accepted - n_accepted_before);
+
+    #ifdef PLOT
+        auto canv = std::make_unique<TCanvas>("canv", "canv");
+        canv->SetGrid();
+        canv->SetTickx();
+        canv->SetTicky();
+
+        gStyle->SetOptStat();
+        gStyle->SetStatH(0.25);
+
+        m_res_mass->SetLineWidth(2);
+        m_res_mass->Draw("hist");
+
+        canv->SaveAs(Form("event/mass/dl/evt_%llu_comb_%s.png", evt, comb_id.Data()));
+    #endif
+
+    Float_t integral = m_res_mass->Integral();
+    if (m_res_mass->GetEntries() && integral > 0.0)
+    {
+        int binmax = m_res_mass->GetMaximumBin(); 
+        res[static_cast<size_t>(Output::mass)] = m_res_mass->GetXaxis()->GetBinCenter(binmax);
+        res[static_cast<size_t>(Output::peak_val)] = m_res_mass->GetBinContent(binmax);
+        res[static_cast<size_t>(Output::width)] = m_q84.Get() - m_q16.Get();
+        res[static_cast<size_t>(Output::integral)] = integral;
+        return res;
+    }
+
+    return res;
+}
+
+// overload with jet resolutions is the entry point of weights method
+std::optional<Float_t> EstimatorDoubleLep::EstimateMass([[maybe_unused]] VecLVF_t const& jets, 
+                                                        [[maybe_unused]] VecLVF_t const& leptons, 
+                                                        [[maybe_unused]] std::vector<Float_t> const& jet_resolutions, 
+                                                        [[maybe_unused]] LorentzVectorF_t const& met, 
+                                                        [[maybe_unused]] ULong64_t evt, 
+                                                        [[maybe_unused]] TString& chosen_comb)
+{
+    throw std::runtime_error("EstimatorDoubleLep: weights method is not implemented in DL channel");
 }
 
 std::optional<Float_t> EstimatorDoubleLep::EstimateMass(VecLVF_t const& jets, 
                                                         VecLVF_t const& leptons, 
-                                                        std::vector<Float_t> const& jet_resolutions, 
                                                         LorentzVectorF_t const& met, 
                                                         ULong64_t evt, 
                                                         TString& chosen_comb)
 {
-    // TODO
+    VecLVF_t particles(static_cast<size_t>(ObjDL::count));
+    particles[static_cast<size_t>(ObjDL::lep1)] = leptons[static_cast<size_t>(Lep::lep1)];
+    particles[static_cast<size_t>(ObjDL::lep2)] = leptons[static_cast<size_t>(Lep::lep2)];
+    particles[static_cast<size_t>(ObjDL::met)] = met;
+
+    std::vector<Float_t> estimations;
+    std::vector<Float_t> integrals;
+    std::vector<Float_t> inv_widths;
+    std::vector<Float_t> peaks;
+    std::vector<TString> labels;
+
+    for (size_t bj1_idx = 0; bj1_idx < NUM_BEST_BTAG; ++bj1_idx)
+    {
+        for (size_t bj2_idx = bj1_idx + 1; bj2_idx < NUM_BEST_BTAG; ++bj2_idx)
+        {
+            if (jets[bj1_idx].Pt() > jets[bj2_idx].Pt())
+            {
+                particles[static_cast<size_t>(ObjDL::bj1)] = jets[bj1_idx];
+                particles[static_cast<size_t>(ObjDL::bj2)] = jets[bj2_idx];
+            }
+            else 
+            {
+                particles[static_cast<size_t>(ObjDL::bj1)] = jets[bj2_idx];
+                particles[static_cast<size_t>(ObjDL::bj2)] = jets[bj1_idx];
+            }
+
+            TString comb_label = Form("b%zub%zu", bj1_idx, bj2_idx);
+            auto comb_result = EstimateCombViaEqns(particles, evt, comb_label);
+
+            if (comb_result[static_cast<size_t>(Output::mass)] > 0.0)
+            {
+                estimations.push_back(comb_result[static_cast<size_t>(Output::mass)]);
+                integrals.push_back(comb_result[static_cast<size_t>(Output::integral)]);
+                inv_widths.push_back(InvWidth(comb_result[static_cast<size_t>(Output::width)]));
+                peaks.push_back(comb_result[static_cast<size_t>(Output::peak_val)]);
+                labels.push_back(comb_label);
+            }
+            Reset(m_res_mass);
+        }
+    }
+
+    if (!estimations.empty())
+    {
+        size_t choice = 0;
+        if (estimations.size() > 1)
+        {
+            MinMaxTransform(integrals.begin(), integrals.end());
+            MinMaxTransform(inv_widths.begin(), inv_widths.end());
+            MinMaxTransform(peaks.begin(), peaks.end());
+
+            Float_t max_metric = 0.0f;
+            for (size_t c = 0; c < estimations.size(); ++c)
+            {
+                Float_t metric = integrals[c] + inv_widths[c] + peaks[c];
+                if (metric > max_metric)
+                {
+                    max_metric = metric;
+                    choice = c;
+                }
+            }
+        }
+        chosen_comb = labels[choice];
+        return std::make_optional<Float_t>(estimations[choice]);
+    }
+
     return std::nullopt;
 }
 
-std::optional<Float_t> EstimatorDoubleLep::EstimateMass(VecLVF_t const& jets, 
-                                                        VecLVF_t const& leptons, 
-                                                        LorentzVectorF_t const& met, 
-                                                        ULong64_t evt, 
-                                                        TString& chosen_comb)
+
+Estimator::Estimator(TString const& pdf_file_name_sl, TString const& pdf_file_name_dl, Method method, Sampling sampling)
+:   m_estimator_sl(pdf_file_name_sl, method)
 {
-    // TODO
-    return std::nullopt;
+    if (method == Method::Eqns)
+    {
+        m_estimator_dl.emplace(pdf_file_name_dl, method, sampling);
+    }
+}
+
+EstimatorBase const& Estimator::Get(Channel ch) const
+{
+    if (ch == Channel::SL)
+    {
+        return m_estimator_sl;
+    }
+    else if (ch == Channel::DL)
+    {
+        if (!m_estimator_dl)
+        {
+            throw std::runtime_error("Estimator::Get: weights method is not implemented in DL channel");
+        }
+        return *m_estimator_dl;
+    }
+    throw std::runtime_error("Estimator::Get: attempting to access estimator for unknown channel");
 }
 
+EstimatorBase& Estimator::Get(Channel ch)
+{
+    return const_cast<EstimatorBase&>(static_cast<Estimator const&>(*this).Get(ch));
+}
 
-Estimator::Estimator(TString const& pdf_file_name_sl, TString const& pdf_file_name_dl)
-:   m_estimator_sl(pdf_file_name_sl)
-,   m_estimator_dl(pdf_file_name_dl)
-{}
+std::optional<Float_t> Estimator::EstimateMass(VecLVF_t const& jets, 
+                                               VecLVF_t const& leptons, 
+                                               std::vector<Float_t> const& jet_resolutions, 
+                                               LorentzVectorF_t const& met, 
+                                               ULong64_t evt, 
+                                               Channel ch,
+                                               TString& chosen_comb)
+{
+    return Get(ch).EstimateMass(jets, leptons, jet_resolutions, met, evt, chosen_comb);
+}
+
+std::optional<Float_t> Estimator::EstimateMass(VecLVF_t const& jets, 
+                                               VecLVF_t const& leptons, 
+                                               LorentzVectorF_t const& met, 
+                                               ULong64_t evt, 
+                                               Channel ch,
+                                               TString& chosen_comb)
+{
+    return Get(ch).EstimateMass(jets, leptons, met, evt, chosen_comb);
+}
 
 
 EstimatorSingLep_Run3::EstimatorSingLep_Run3(TString const& file_name)
@@ -2,6 +2,8 @@
 #define ESTIMATOR_HPP
 
 #include <optional>
+#include <cmath>
+#include <algorithm>
 #include <stdexcept>
 
 #include "TRandom3.h"
@@ -10,6 +12,9 @@
 #include "EstimatorUtils.hpp"
 #include "EstimatorTools.hpp"
 #include "Constants.hpp"
+#include "PDFBundle.hpp"
+#include "PDFTable.hpp"
+#include "P2Quantile.hpp"
 
 
 class EstimatorBase
@@ -43,18 +48,133 @@ class EstimatorBase
                                                 ULong64_t evt, 
                                                 TString& chosen_comb) = 0;
 
+    // fraction of sampling iterations that produced at least one mass estimate
+    inline Float_t GetEfficiency() const { return m_n_iter ? static_cast<Float_t>(m_n_accepted)/m_n_iter : 0.0f; }
+    inline ULong64_t GetNumIterations() const { return m_n_iter; }
+    inline ULong64_t GetNumAccepted() const { return m_n_accepted; }
+    // acceptance of sampling iterations of a single combination averaged over combinations
+    inline Float_t GetMeanCombAcceptance() const { return m_n_comb ? m_sum_comb_acc/m_n_comb : 0.0f; }
+    inline Float_t GetRmsCombAcceptance() const 
+    { 
+        Float_t mean = GetMeanCombAcceptance();
+        return m_n_comb ? std::sqrt(std::max(0.0, m_sum2_comb_acc/m_n_comb - mean*mean)) : 0.0f; 
+    }
+    inline ULong64_t GetNumCombinations() const { return m_n_comb; }
+    // fraction of sampled jet corrections for which jet pair mass constraint has no solution
+    inline Float_t GetRescFailureRate() const { return m_n_resc ? static_cast<Float_t>(m_n_resc_failed)/m_n_resc : 0.0f; }
+
+    inline void ResetEfficiency() 
+    { 
+        m_n_iter = 0; 
+        m_n_accepted = 0; 
+        m_n_comb = 0;
+        m_sum_comb_acc = 0.0;
+        m_sum2_comb_acc = 0.0;
+        m_n_resc = 0;
+        m_n_resc_failed = 0;
+    }
+
+    // method PDFs were loaded for, estimating with the other method is an error
+    inline Method GetMethod() const { return m_method; }
+
+    // mass peak of every combination estimated with eqns method after given numbers of iterations (increasing, <= N_ITER),
+    // one trace is appended per combination, nothing is recorded while checkpoints are empty; used by bench_smooth
+    inline void SetPeakCheckpoints(std::vector<int> const& checkpoints) { m_peak_checkpoints = checkpoints; m_peak_traces.clear(); }
+    inline std::vector<std::vector<Float_t>> const& GetPeakTraces() const { return m_peak_traces; }
+    inline void ClearPeakTraces() { m_peak_traces.clear(); }
+
     protected:
-    HistVec_t<TH1F> m_pdf_1d;
-    HistVec_t<TH2F> m_pdf_2d;
+    // *.bundle files are memory mapped, ROOT files are converted to a bundle in memory
+    // only PDFs required by method (and by importance sampling in DL channel) are read; views of other PDFs are left empty
+    void LoadPDFs(TString const& pdf_file_name, Channel ch, Method method, Sampling sampling = Sampling::Uniform);
+
+    // draws from 1d PDF: inverse CDF of histogram, or of its monotone spline smoothing with -DSMOOTH_PDF
+    inline double Draw(PDF1DView const& pdf) const
+    {
+        #ifdef SMOOTH_PDF
+            return pdf.SampleSmooth(m_prg.get());
+        #else
+            return pdf.Sample(m_prg.get());
+        #endif
+    }
+
+    // unit-area density of Draw, norm is area of histogram
+    inline Float_t DrawDensity(PDF1DView const& pdf, double x, [[maybe_unused]] double norm) const
+    {
+        #ifdef SMOOTH_PDF
+            return pdf.SmoothDensity(x);
+        #else
+            return pdf.Density(x)/norm;
+        #endif
+    }
+
+    Method m_method = Method::Eqns;
+    PDFBundle m_pdfs;
+    std::vector<PDF1DView> m_pdf_1d;
+    std::vector<PDF2DView> m_pdf_2d;
     std::unique_ptr<TRandom3> m_prg;
     UHist_t<TH1F> m_res_mass; 
+
+    ULong64_t m_n_iter = 0;
+    ULong64_t m_n_accepted = 0;
+
+    ULong64_t m_n_comb = 0;
+    double m_sum_comb_acc = 0.0;
+    double m_sum2_comb_acc = 0.0;
+    ULong64_t m_n_resc = 0;
+    ULong64_t m_n_resc_failed = 0;
+
+    inline void AddCombAcceptance(ULong64_t n_iter, ULong64_t n_accepted)
+    {
+        if (n_iter == 0)
+        {
+            return;
+        }
+        double acc = static_cast<double>(n_accepted)/n_iter;
+        ++m_n_comb;
+        m_sum_comb_acc += acc;
+        m_sum2_comb_acc += acc*acc;
+    }
+
+    // streaming quantiles of masses of current combination
+    P2Quantile m_q16;
+    P2Quantile m_q50;
+    P2Quantile m_q84;
+
+    inline void ResetQuantiles() { m_q16.Reset(); m_q50.Reset(); m_q84.Reset(); }
+
+    std::vector<int> m_peak_checkpoints;
+    std::vector<std::vector<Float_t>> m_peak_traces;
+    size_t m_next_checkpoint = 0;
+
+    inline void StartPeakTrace()
+    {
+        if (!m_peak_checkpoints.empty())
+        {
+            m_peak_traces.emplace_back();
+            m_next_checkpoint = 0;
+        }
+    }
+
+    // peak of m_res_mass if n_iter iterations are done at the next checkpoint, -1 while histogram is empty
+    // traces assume all N_ITER iterations are run, i.e. a build without EARLY_STOP
+    inline void RecordPeak(int n_iter)
+    {
+        if (m_next_checkpoint < m_peak_checkpoints.size() && m_peak_checkpoints[m_next_checkpoint] == n_iter)
+        {
+            Float_t peak = m_res_mass->GetEntries() ? m_res_mass->GetXaxis()->GetBinCenter(m_res_mass->GetMaximumBin()) : -1.0f;
+            m_peak_traces.back().push_back(peak);
+            ++m_next_checkpoint;
+        }
+    }
+    inline void AddToQuantiles(Float_t mass, Float_t weight = 1.0f) { m_q16.Add(mass, weight); m_q50.Add(mass, weight); m_q84.Add(mass, weight); }
 };
 
 
 class EstimatorSingleLep final : public EstimatorBase
 {
     public:
-    EstimatorSingleLep(TString const& pdf_file_name);
+    EstimatorSingleLep(TString const& pdf_file_name, Method method = Method::Eqns);
 
     std::array<Float_t, OUTPUT_SIZE> EstimateCombViaWeights(VecLVF_t const& particles, 
                                                             std::pair<Float_t, Float_t> lj_pt_res, 
@@ -77,13 +197,25 @@ class EstimatorSingleLep final : public EstimatorBase
                                         LorentzVectorF_t const& met, 
                                         ULong64_t evt, 
                                         TString& chosen_comb) override;
+
+    private:
+    std::optional<Float_t> EstimateMassImpl(VecLVF_t const& jets, 
+                                            VecLVF_t const& leptons, 
+                                            std::vector<Float_t> const* jet_resolutions, 
+                                            LorentzVectorF_t const& met, 
+                                            ULong64_t evt, 
+                                            TString& chosen_comb);
+
+    PDFTable1D m_table_mbb;
+    PDFTable1D m_table_mww;
+    PDFTable1D m_table_hh_dphi;
 };
 
 
 class EstimatorDoubleLep final : public EstimatorBase
 {
     public:
-    EstimatorDoubleLep(TString const& pdf_file_name);
+    EstimatorDoubleLep(TString const& pdf_file_name, Method method = Method::Eqns, Sampling sampling = Sampling::Uniform);
 
     std::array<Float_t, OUTPUT_SIZE> EstimateCombViaWeights(VecLVF_t const& particles, 
                                                             std::pair<Float_t, Float_t> lj_pt_res, 
@@ -106,17 +238,47 @@ class EstimatorDoubleLep final : public EstimatorBase
                                         LorentzVectorF_t const& met, 
                                         ULong64_t evt, 
                                         TString& chosen_comb) override;
+
+    // importance sampling is only possible if proposal PDFs were loaded, i.e. estimator was constructed with it
+    void SetSampling(Sampling sampling);
+    inline Sampling GetSampling() const { return m_sampling; }
+
+    private:
+    Sampling m_sampling;
+    Float_t m_nulep_deta_norm = 1.0;
+    Float_t m_nulep_dphi_norm = 1.0;
 };
 
 
 class Estimator
 {
     public:
-    Estimator(TString const& pdf_file_name_sl, TString const& pdf_file_name_dl);
+    // sampling of neutrino direction in DL channel
+    Estimator(TString const& pdf_file_name_sl, TString const& pdf_file_name_dl, Method method = Method::Eqns, Sampling sampling = Sampling::Uniform);
+
+    std::optional<Float_t> EstimateMass(VecLVF_t const& jets, 
+                                        VecLVF_t const& leptons, 
+                                        std::vector<Float_t> const& jet_resolutions, 
+                                        LorentzVectorF_t const& met, 
+                                        ULong64_t evt, 
+                                        Channel ch,
+                                        TString& chosen_comb);
+
+    std::optional<Float_t> EstimateMass(VecLVF_t const& jets, 
+                                        VecLVF_t const& leptons, 
+                                        LorentzVectorF_t const& met, 
+                                        ULong64_t evt, 
+                                        Channel ch,
+                                        TString& chosen_comb);
+
+    EstimatorBase const& Get(Channel ch) const;
+    EstimatorBase& Get(Channel ch);
+    inline bool HasChannel(Channel ch) const { return ch == Channel::SL || m_estimator_dl.has_value(); }
 
     private:
     EstimatorSingleLep m_estimator_sl;
-    EstimatorDoubleLep m_estimator_dl;
+    // DL channel has only eqns method, estimator is not created for weights
+    std::optional<EstimatorDoubleLep> m_estimator_dl;
 };
 
 
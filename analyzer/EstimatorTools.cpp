@@ -1,6 +1,12 @@
 #include "EstimatorTools.hpp"
+#include "FastMath.hpp"
 
-#include "TVector2.h"
+using hme_math::Acosh;
+using hme_math::Atan2;
+using hme_math::Cosh;
+using hme_math::Log;
+using hme_math::Phi_mpi_pi;
+using hme_math::Sinh;
 
 LorentzVectorF_t SamplePNetResCorr(LorentzVectorF_t const& jet, std::unique_ptr<TRandom3>& prg, Float_t resolution)
 {
@@ -13,30 +19,54 @@ LorentzVectorF_t SamplePNetResCorr(LorentzVectorF_t const& jet, std::unique_ptr<
     return LorentzVectorF_t(pt + dpt, jet.Eta(), jet.Phi(), jet.M());
 }
 
-std::optional<std::pair<Float_t, Float_t>> ComputeJetResc(LorentzVectorF_t const& p1, LorentzVectorF_t const& p2, UHist_t<TH1F>& pdf, Float_t mass)
+namespace
 {
-    Float_t c1 = pdf->GetRandom();
-    Float_t x1 = p2.M2();
-    Float_t x2 = 2.0*c1*(p1.Dot(p2));
-    Float_t x3 = c1*c1*p1.M2() - mass*mass;
-    Float_t discrim = x2*x2 - 4.0*x1*x3;
-    if (x2 >= 0.0 && x1 != 0.0 && discrim >= 0.0)
+    // c2 such that mass of (c1*p1 + c2*p2) is equal to mass
+    std::optional<std::pair<Float_t, Float_t>> SolveJetResc(LorentzVectorF_t const& p1, LorentzVectorF_t const& p2, Float_t c1, Float_t mass)
     {
-        Float_t c2 = (-x2 + std::sqrt(discrim))/(2.0*x1);
-        if (c2 >= 0.0)
+        Float_t x1 = p2.M2();
+        Float_t x2 = 2.0*c1*(p1.Dot(p2));
+        Float_t x3 = c1*c1*p1.M2() - mass*mass;
+        Float_t discrim = x2*x2 - 4.0*x1*x3;
+        if (x2 >= 0.0 && x1 != 0.0 && discrim >= 0.0)
         {
-            return std::make_optional<std::pair<Float_t, Float_t>>(c1, c2); 
+            Float_t c2 = (-x2 + std::sqrt(discrim))/(2.0*x1);
+            if (c2 >= 0.0)
+            {
+                return std::make_optional<std::pair<Float_t, Float_t>>(c1, c2); 
+            }
         }
+        // return {1.0, 1.0};
+        return std::nullopt;
     }
-    // return {1.0, 1.0};
-    return std::nullopt;
+}
+
+std::optional<std::pair<Float_t, Float_t>> ComputeJetResc(LorentzVectorF_t const& p1, LorentzVectorF_t const& p2, UHist_t<TH1F>& pdf, Float_t mass)
+{
+    return SolveJetResc(p1, p2, pdf->GetRandom(), mass);
+}
+
+// samples with gRandom like TH1::GetRandom called without generator
+std::optional<std::pair<Float_t, Float_t>> ComputeJetResc(LorentzVectorF_t const& p1, LorentzVectorF_t const& p2, PDF1DView const& pdf, Float_t mass)
+{
+    #ifdef SMOOTH_PDF
+        return SolveJetResc(p1, p2, pdf.SampleSmooth(gRandom), mass);
+    #else
+        return SolveJetResc(p1, p2, pdf.Sample(gRandom), mass);
+    #endif
+}
+
+// c1 is sampled from the row of pt of p1 of PDF conditioned on jet pt
+std::optional<std::pair<Float_t, Float_t>> ComputeJetResc(LorentzVectorF_t const& p1, LorentzVectorF_t const& p2, PDF2DView const& pdf, Float_t mass)
+{
+    return SolveJetResc(p1, p2, pdf.SampleX(p1.Pt(), gRandom), mass);
 }
 
 std::optional<LorentzVectorF_t> NuFromOnshellW(Float_t eta, Float_t phi, Float_t mw, LorentzVectorF_t const& lep_onshell)
 {
     Float_t deta = eta - lep_onshell.Eta();
     Float_t dphi = phi - lep_onshell.Phi();
-    Float_t pt = mw*mw/(2.0*lep_onshell.Pt()*(std::cosh(deta) - std::cos(dphi)));
+    Float_t pt = mw*mw/(2.0*lep_onshell.Pt()*(Cosh(deta) - std::cos(dphi)));
 
     if (std::isinf(pt) || std::isnan(pt))
     {
@@ -70,7 +100,7 @@ std::optional<LorentzVectorF_t> NuFromOffshellW(LorentzVectorF_t const& lep1,
 
     // pt and phi of nu2 are determined by difference of met and transverse component of nu1
     Float_t pt = std::sqrt(nu_tmp_px*nu_tmp_px + nu_tmp_py*nu_tmp_py);
-    Float_t phi = std::atan2(nu_tmp_py, nu_tmp_px);
+    Float_t phi = Atan2(nu_tmp_py, nu_tmp_px);
 
     Float_t cosh_deta = (mh*mh + 2.0*(nu_tmp_px*tmp.Px() + nu_tmp_py*tmp.Py()) - tmp.M2())/(2.0*tmp2.Pt()*pt);
     if (cosh_deta < 1.0)
@@ -78,7 +108,7 @@ std::optional<LorentzVectorF_t> NuFromOffshellW(LorentzVectorF_t const& lep1,
         return std::nullopt;
     }
 
-    Float_t delta_eta = std::acosh(cosh_deta);
+    Float_t delta_eta = Acosh(cosh_deta);
     Float_t eta = control == 1 ? tmp2.Eta() - delta_eta : tmp2.Eta() + delta_eta;
 
     if (std::abs(eta) > 7.0)
@@ -97,7 +127,7 @@ std::optional<LorentzVectorF_t> NuFromH(LorentzVectorF_t const& jet1,
                                         Float_t mh)
 {
     LorentzVectorF_t vis = jet1 + jet2 + lep;
-    Float_t cos_dphi = std::cos(TVector2::Phi_mpi_pi(vis.Phi() - met.Phi())); 
+    Float_t cos_dphi = std::cos(Phi_mpi_pi(vis.Phi() - met.Phi())); 
     Float_t mt = mT(vis);
     Float_t mv2 = vis.M2();
     Float_t pt = met.Pt(); 
@@ -119,7 +149,7 @@ std::optional<LorentzVectorF_t> NuFromH(LorentzVectorF_t const& jet1,
     {
         return std::nullopt;
     }
-    Float_t dy = std::acosh(cosh_dy);
+    Float_t dy = Acosh(cosh_dy);
     Float_t y = add_deta ? vis.ColinearRapidity() + dy : vis.ColinearRapidity() - dy;
     if (std::abs(y) > 7.0)
     {
@@ -172,13 +202,13 @@ std::optional<LorentzVectorF_t> NuFromW(LorentzVectorF_t const& lep, LorentzVect
 {
     Float_t pt = met.Pt();
     Float_t phi = met.Phi();
-    Float_t dphi = TVector2::Phi_mpi_pi(phi - lep.Phi());
+    Float_t dphi = Phi_mpi_pi(phi - lep.Phi());
     Float_t cosh_deta = mw*mw/(2.0*lep.Pt()*pt) + std::cos(dphi);    
     if (cosh_deta < 1.0)
     {
         return std::nullopt;
     }
-    Float_t delta_eta = std::acosh(cosh_deta);
+    Float_t delta_eta = Acosh(cosh_deta);
     Float_t eta = add_deta ? lep.Eta() + delta_eta : lep.Eta() - delta_eta;
     if (std::abs(eta) > 7.0)
     {
@@ -193,15 +223,15 @@ std::optional<std::pair<LorentzVectorF_t, LorentzVectorF_t>> NuFromConstraints(L
 {
     LorentzVectorF_t vis = jet1 + jet2 + lep;
     Float_t phi = met.Phi();
-    Float_t cos_dphi_nulep = std::cos(TVector2::Phi_mpi_pi(phi - lep.Phi()));
-    Float_t cos_dphi_nuvis = std::cos(TVector2::Phi_mpi_pi(phi - vis.Phi()));
+    Float_t cos_dphi_nulep = std::cos(Phi_mpi_pi(phi - lep.Phi()));
+    Float_t cos_dphi_nuvis = std::cos(Phi_mpi_pi(phi - vis.Phi()));
 
     Float_t A = (mh*mh - vis.M2())*lep.Pt();
     Float_t B = mw*mw*mT(vis);
     Float_t C = (mh*mh - vis.M2())*lep.Pt()*cos_dphi_nulep - mw*mw*vis.Pt()*cos_dphi_nuvis;
 
-    Float_t D = A*std::cosh(lep.ColinearRapidity()) - B*std::cosh(vis.ColinearRapidity());
-    Float_t E = -A*std::sinh(lep.ColinearRapidity()) + B*std::sinh(vis.ColinearRapidity());
+    Float_t D = A*Cosh(lep.ColinearRapidity()) - B*Cosh(vis.ColinearRapidity());
+    Float_t E = -A*Sinh(lep.ColinearRapidity()) + B*Sinh(vis.ColinearRapidity());
 
     // eqn trying to solve:
     // (D - E)x^2 - 2Cx + (D + E) = 0
@@ -222,8 +252,8 @@ std::optional<std::pair<LorentzVectorF_t, LorentzVectorF_t>> NuFromConstraints(L
         {
             return std::nullopt;
         }
-        Float_t y = -std::log(exp_neg_y);
-        Float_t cosh_dy_nulep = std::cosh(y - lep.ColinearRapidity());
+        Float_t y = -Log(exp_neg_y);
+        Float_t cosh_dy_nulep = Cosh(y - lep.ColinearRapidity());
         Float_t pt = mw*mw/(2.0*lep.Pt()*(cosh_dy_nulep - cos_dphi_nulep));
         if (pt < 0.0 || std::isnan(pt) || std::isinf(pt))
         {
@@ -248,8 +278,8 @@ std::optional<std::pair<LorentzVectorF_t, LorentzVectorF_t>> NuFromConstraints(L
         {
             return std::nullopt;
         }
-        Float_t y = -std::log(exp_neg_y);
-        Float_t cosh_dy_nulep = std::cosh(y - lep.ColinearRapidity());
+        Float_t y = -Log(exp_neg_y);
+        Float_t cosh_dy_nulep = Cosh(y - lep.ColinearRapidity());
         Float_t pt = mw*mw/(2.0*lep.Pt()*(cosh_dy_nulep - cos_dphi_nulep));
         if (pt < 0.0 || std::isnan(pt) || std::isinf(pt))
         {
@@ -270,8 +300,8 @@ std::optional<std::pair<LorentzVectorF_t, LorentzVectorF_t>> NuFromConstraints(L
     LorentzVectorF_t nu1, nu2;
     if (exp_neg_y1 > 0.0)
     {
-        Float_t y1 = -std::log(exp_neg_y1);
-        Float_t cosh_dy_nulep = std::cosh(y1 - lep.ColinearRapidity());
+        Float_t y1 = -Log(exp_neg_y1);
+        Float_t cosh_dy_nulep = Cosh(y1 - lep.ColinearRapidity());
         Float_t pt = mw*mw/(2.0*lep.Pt()*(cosh_dy_nulep - cos_dphi_nulep));
         bool invalid_pt = pt < 0.0 || std::isnan(pt) || std::isinf(pt);
         if (!invalid_pt)
@@ -282,8 +312,8 @@ std::optional<std::pair<LorentzVectorF_t, LorentzVectorF_t>> NuFromConstraints(L
     
     if (exp_neg_y2 > 0.0)
     {
-        Float_t y2 = -std::log(exp_neg_y2);
-        Float_t cosh_dy_nulep = std::cosh(y2 - lep.ColinearRapidity());
+        Float_t y2 = -Log(exp_neg_y2);
+        Float_t cosh_dy_nulep = Cosh(y2 - lep.ColinearRapidity());
         Float_t pt = mw*mw/(2.0*lep.Pt()*(cosh_dy_nulep - cos_dphi_nulep));
         bool invalid_pt = pt < 0.0 || std::isnan(pt) || std::isinf(pt);
         if (!invalid_pt)
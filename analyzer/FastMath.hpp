@@ -0,0 +1,141 @@
+#ifndef FAST_MATH_HPP
+#define FAST_MATH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "RtypesCore.h"
+#include "TVector2.h"
+
+// single precision approximations of elementary functions used by neutrino solvers
+// all kernels are branch-light inline functions without table lookups so that loops over samples can be vectorized
+// error bounds are maximal |approx - exact|/ulp(exact) with exact result evaluated in double precision,
+// measured by exhaustive scan of all floats in the quoted domain (atan2: scan of 15000x12000 grid in [-10, 10]^2),
+// a correctly rounded kernel would have 0.5 ULP
+namespace fast_math
+{
+    inline constexpr Float_t LN2 = 0.693147180559945f;
+    inline constexpr Float_t INV_LN2 = 1.44269504088896f;
+    inline constexpr Float_t PI = 3.14159265358979f;
+    inline constexpr Float_t TWO_PI = 6.28318530717959f;
+    inline constexpr Float_t INV_TWO_PI = 0.159154943091895f;
+
+    inline std::int32_t AsInt(Float_t x) { std::int32_t i; std::memcpy(&i, &x, sizeof(i)); return i; }
+    inline Float_t AsFloat(std::int32_t i) { Float_t x; std::memcpy(&x, &i, sizeof(x)); return x; }
+
+    // x in [1e-30, 1e30]: <= 2.85 ULP
+    // x <= 0 returns NaN, consistent with std::log only for x < 0 (std::log(0) = -inf)
+    inline Float_t log(Float_t x)
+    {
+        // x = m*2^e, m in [sqrt(2)/2, sqrt(2))
+        std::int32_t ix = AsInt(x) - AsInt(0.707106781f);
+        std::int32_t e = ix >> 23;
+        Float_t m = AsFloat((ix & 0x007fffff) + AsInt(0.707106781f));
+
+        // log(m) = 2*atanh(s), s = (m - 1)/(m + 1), |s| <= 0.1716
+        Float_t s = (m - 1.0f)/(m + 1.0f);
+        Float_t s2 = s*s;
+        Float_t p = 2.0f + s2*(0.666666667f + s2*(0.4f + s2*(0.285714286f + s2*0.222222222f)));
+        Float_t res = s*p + static_cast<Float_t>(e)*LN2;
+        return x > 0.0f ? res : std::numeric_limits<Float_t>::quiet_NaN();
+    }
+
+    // |x| <= 87: <= 1.22 ULP, overflows to inf above 88.7 and underflows to 0 below -87.3
+    inline Float_t exp(Float_t x)
+    {
+        x = x < 88.7f ? x : 88.7f;
+        x = x > -87.3f ? x : -87.3f;
+
+        // x = k*ln2 + r, |r| <= ln2/2
+        Float_t k = std::nearbyint(x*INV_LN2);
+        Float_t r = (x - k*0.693145752f) - k*1.42860677e-6f;
+
+        // Taylor polynomial of degree 7, truncation error < 7e-9
+        Float_t p = 1.0f + r*(1.0f + r*(0.5f + r*(0.166666667f + r*(0.0416666667f + r*(0.00833333333f + r*(0.00138888889f + r*0.000198412698f))))));
+        Float_t res = AsFloat(AsInt(p) + (static_cast<std::int32_t>(k) << 23));
+        return x < 88.7f ? res : std::numeric_limits<Float_t>::infinity();
+    }
+
+    // |x| <= 87: <= 1.66 ULP
+    inline Float_t cosh(Float_t x)
+    {
+        Float_t e = exp(std::abs(x));
+        return 0.5f*(e + 1.0f/e);
+    }
+
+    // |x| <= 87: <= 2.18 ULP
+    inline Float_t sinh(Float_t x)
+    {
+        Float_t ax = std::abs(x);
+        // cancellation in e - 1/e for small arguments: use series instead
+        Float_t x2 = x*x;
+        Float_t series = x*(1.0f + x2*(0.166666667f + x2*(0.00833333333f + x2*0.000198412698f)));
+        Float_t e = exp(ax);
+        Float_t res = std::copysign(0.5f*(e - 1.0f/e), x);
+        return ax < 0.5f ? series : res;
+    }
+
+    // x in [1, inf): <= 5.69 ULP for x >= 1.01, absolute error <= 1e-7 in [1, 1.01)
+    // x < 1 returns NaN as std::acosh
+    inline Float_t acosh(Float_t x)
+    {
+        // large arguments: acosh(x) = log(2x) up to 1/(4x^2)
+        Float_t res = x < 1e4f ? log(x + std::sqrt((x - 1.0f)*(x + 1.0f))) : log(x) + LN2;
+        return x >= 1.0f ? res : std::numeric_limits<Float_t>::quiet_NaN();
+    }
+
+    // finite (y, x): <= 3.22 ULP, absolute error <= 3e-7, atan2(0, 0) = 0
+    inline Float_t atan2(Float_t y, Float_t x)
+    {
+        Float_t ax = std::abs(x);
+        Float_t ay = std::abs(y);
+        Float_t num = ax < ay ? ax : ay;
+        Float_t den = ax < ay ? ay : ax;
+        Float_t z = den > 0.0f ? num/den : 0.0f;
+
+        // reduce z in [0, 1] to |t| <= tan(pi/8)
+        bool big = z > 0.414213562f;
+        Float_t t = big ? (z - 1.0f)/(z + 1.0f) : z;
+        Float_t t2 = t*t;
+        Float_t a = (((0.0805374449538f*t2 - 0.138776856032f)*t2 + 0.199777106478f)*t2 - 0.333329491539f)*t2*t + t;
+        a = big ? a + 0.25f*PI : a;
+
+        a = ay > ax ? 0.5f*PI - a : a;
+        a = x < 0.0f ? PI - a : a;
+        return std::copysign(a, y);
+    }
+
+    // maps finite angle to [-pi, pi] up to rounding of 2*pi
+    // absolute error <= 4e-7 for |x| <= 4*pi, i.e. differences of two angles
+    inline Float_t Phi_mpi_pi(Float_t x)
+    {
+        Float_t res = x - TWO_PI*std::nearbyint(x*INV_TWO_PI);
+        return res < PI ? res : res - TWO_PI;
+    }
+}
+
+// dispatch used by estimator code: approximate kernels are selected with -DFAST_MATH
+namespace hme_math
+{
+    #ifdef FAST_MATH
+        inline Float_t Log(Float_t x) { return fast_math::log(x); }
+        inline Float_t Exp(Float_t x) { return fast_math::exp(x); }
+        inline Float_t Cosh(Float_t x) { return fast_math::cosh(x); }
+        inline Float_t Sinh(Float_t x) { return fast_math::sinh(x); }
+        inline Float_t Acosh(Float_t x) { return fast_math::acosh(x); }
+        inline Float_t Atan2(Float_t y, Float_t x) { return fast_math::atan2(y, x); }
+        inline Float_t Phi_mpi_pi(Float_t x) { return fast_math::Phi_mpi_pi(x); }
+    #else
+        inline Float_t Log(Float_t x) { return std::log(x); }
+        inline Float_t Exp(Float_t x) { return std::exp(x); }
+        inline Float_t Cosh(Float_t x) { return std::cosh(x); }
+        inline Float_t Sinh(Float_t x) { return std::sinh(x); }
+        inline Float_t Acosh(Float_t x) { return std::acosh(x); }
+        inline Float_t Atan2(Float_t y, Float_t x) { return std::atan2(y, x); }
+        inline Float_t Phi_mpi_pi(Float_t x) { return TVector2::Phi_mpi_pi(x); }
+    #endif
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef GEN_BRANCH_HPP
+#define GEN_BRANCH_HPP
+
+#include <string>
+#include <stdexcept>
+
+#include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TLorentzVector.h"
+#include "TString.h"
+
+// gen branches are stored as Double_t in SL ntuples and as Float_t in DL ntuples
+// type is taken from the leaf, value is always returned as double
+class GenBranch
+{
+    public:
+    void Connect(TTree* tree, TString const& name)
+    {
+        TBranch* branch = tree->GetBranch(name);
+        if (!branch)
+        {
+            throw std::runtime_error("No branch " + std::string(name.Data()));
+        }
+
+        TLeaf* leaf = branch->GetLeaf(name);
+        m_is_double = leaf && TString(leaf->GetTypeName()) == "Double_t";
+        if (m_is_double)
+        {
+            tree->SetBranchAddress(name, &m_double);
+        }
+        else
+        {
+            tree->SetBranchAddress(name, &m_float);
+        }
+    }
+
+    inline double Get() const { return m_is_double ? m_double : m_float; }
+
+    private:
+    Double_t m_double = 0.0;
+    Float_t m_float = 0.0;
+    bool m_is_double = false;
+};
+
+struct GenP4Branches
+{
+    GenBranch pt;
+    GenBranch eta;
+    GenBranch phi;
+    GenBranch mass;
+
+    void Connect(TTree* tree, TString const& prefix)
+    {
+        pt.Connect(tree, prefix + "_pt");
+        eta.Connect(tree, prefix + "_eta");
+        phi.Connect(tree, prefix + "_phi");
+        mass.Connect(tree, prefix + "_mass");
+    }
+
+    TLorentzVector P4() const
+    {
+        TLorentzVector p4;
+        p4.SetPtEtaPhiM(pt.Get(), eta.Get(), phi.Get(), mass.Get());
+        return p4;
+    }
+};
+
+#endif
@@ -5,85 +5,138 @@
 #include "THStack.h"
 #include "TLegend.h"
 #include "TString.h"
+#include "TFile.h"
+
+#include <stdexcept>
+
+// zstd, level 5 (algorithm*100 + level)
+inline constexpr int HIST_FILE_COMPRESSION = 505;
 
 HistManager::HistManager(std::string path) 
 :   m_path(path)
 {}
 
-void HistManager::Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& range, int n_bins)
+Hist1DHandle HistManager::Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& range, int n_bins)
 {
-    m_hists_1d.insert({std::move(hist_name), MakeItem1D(hist_name, title, labels, range, n_bins)});
+    auto [it, inserted] = m_index_1d.insert({hist_name, static_cast<int>(m_hists_1d.size())});
+    if (inserted)
+    {
+        m_hists_1d.push_back(MakeItem1D(hist_name, title, labels, range, n_bins));
+    }
+    return Hist1DHandle(it->second);
 }
 
-void HistManager::Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& xrange, Range const& yrange, Bins const& bins)
+Hist2DHandle HistManager::Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& xrange, Range const& yrange, Bins const& bins)
 {
-    m_hists_2d.insert({std::move(hist_name), MakeItem2D(hist_name, title, labels, xrange, yrange, bins)});
+    auto [it, inserted] = m_index_2d.insert({hist_name, static_cast<int>(m_hists_2d.size())});
+    if (inserted)
+    {
+        m_hists_2d.push_back(MakeItem2D(hist_name, title, labels, xrange, yrange, bins));
+    }
+    return Hist2DHandle(it->second);
 }
 
 void HistManager::Fill(std::string const& hist_name, double value)
 {
-    auto const& [hist, hist_info] = m_hists_1d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_1d[m_index_1d.at(hist_name)]; 
     hist->Fill(value);
 }
 
 void HistManager::FillWeighted(std::string const& hist_name, double value, double weight)
 {
-    auto const& [hist, hist_info] = m_hists_1d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_1d[m_index_1d.at(hist_name)]; 
     hist->Fill(value, weight);
 }
 
 void HistManager::Fill(std::string const& hist_name, double xval, double yval)
 {
-    auto const& [hist, hist_info] = m_hists_2d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_2d[m_index_2d.at(hist_name)]; 
     hist->Fill(xval, yval);
 }
 
 void HistManager::FillWeighted(std::string const& hist_name, double xval, double yval, double weight)
 {
-    auto const& [hist, hist_info] = m_hists_2d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_2d[m_index_2d.at(hist_name)]; 
     hist->Fill(xval, yval, weight);
 }
 
-void HistManager::Draw() const
+HistManager HistManager::MakeShard() const
 {
-    for (auto const& [hist_name, hhi_pair]: m_hists_1d)
+    HistManager shard(m_path);
+    for (auto const& [ptr_hist, hist_info]: m_hists_1d)
     {
-        auto const& [ptr_hist, hist_info] = hhi_pair;
         auto const& [title, labels, range, nbins] = hist_info;
-        auto const& [xlabel, ylabel] = labels;
-        auto c1 = std::make_unique<TCanvas>("c1", "c1");
-        c1->SetGrid();
-        c1->SetTickx();
-        c1->SetTicky();
+        shard.Add(ptr_hist->GetName(), title, labels, range, nbins);
+    }
+
+    for (auto const& [ptr_hist, hist_info]: m_hists_2d)
+    {
+        auto const& [title, labels, xrange, yrange, bins] = hist_info;
+        shard.Add(ptr_hist->GetName(), title, labels, xrange, yrange, bins);
+    }
+    return shard;
+}
+
+void HistManager::Merge(HistManager const& shard)
+{
+    if (shard.m_hists_1d.size() != m_hists_1d.size() || shard.m_hists_2d.size() != m_hists_2d.size())
+    {
+        throw std::runtime_error("HistManager::Merge: shard has different histograms");
+    }
+
+    for (size_t i = 0; i < m_hists_1d.size(); ++i)
+    {
+        m_hists_1d[i].first->Add(shard.m_hists_1d[i].first.get());
+    }
+
+    for (size_t i = 0; i < m_hists_2d.size(); ++i)
+    {
+        m_hists_2d[i].first->Add(shard.m_hists_2d[i].first.get());
+    }
+}
+
+void HistManager::Write(std::string const& file_name) const
+{
+    std::unique_ptr<TFile> file(TFile::Open(file_name.c_str(), "RECREATE", "", HIST_FILE_COMPRESSION));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to create file " + file_name);
+    }
 
+    for (auto const& [ptr_hist, hist_info]: m_hists_1d)
+    {
+        auto const& [xlabel, ylabel] = hist_info.m_axis_labels;
         ptr_hist->GetXaxis()->SetTitle(xlabel.c_str());
         ptr_hist->GetYaxis()->SetTitle(ylabel.c_str());
-        ptr_hist->SetLineWidth(3);
-        ptr_hist->SetStats(1);
-        ptr_hist->Draw();
-        // c1->SaveAs(Form("histograms/%s.png", hist_name.c_str()));
-        c1->SaveAs(Form("%s/%s.png", m_path.c_str(), hist_name.c_str()));
+        file->WriteTObject(ptr_hist.get());
     }
 
-    for (auto const& [hist_name, hhi_pair]: m_hists_2d)
+    for (auto const& [ptr_hist, hist_info]: m_hists_2d)
     {
-        auto const& [ptr_hist, hist_info] = hhi_pair;
-        auto const& [title, labels, xrange, yrange, bins] = hist_info;
-        auto const& [xlabel, ylabel] = labels;
-        auto c1 = std::make_unique<TCanvas>("c1", "c1");
-        c1->SetGrid();
-        c1->SetTickx();
-        c1->SetTicky();
+        auto const& [xlabel, ylabel] = hist_info.m_axis_labels;
+        ptr_hist->GetXaxis()->SetTitle(xlabel.c_str());
+        ptr_hist->GetYaxis()->SetTitle(ylabel.c_str());
+        file->WriteTObject(ptr_hist.get());
+    }
+    file->Close();
+}
 
-        auto gStyle = std::make_unique<TStyle>();
-        gStyle->SetPalette(kRainBow);
+void HistManager::Draw() const
+{
+    for (auto const& [ptr_hist, hist_info]: m_hists_1d)
+    {
+        auto const& [xlabel, ylabel] = hist_info.m_axis_labels;
+        ptr_hist->GetXaxis()->SetTitle(xlabel.c_str());
+        ptr_hist->GetYaxis()->SetTitle(ylabel.c_str());
+        SaveHist1D(ptr_hist.get(), m_path);
+    }
 
+    for (auto const& [ptr_hist, hist_info]: m_hists_2d)
+    {
+        auto const& [xlabel, ylabel] = hist_info.m_axis_labels;
         ptr_hist->GetXaxis()->SetTitle(xlabel.c_str());
         ptr_hist->GetYaxis()->SetTitle(ylabel.c_str());
-        ptr_hist->SetStats(0);
-        ptr_hist->Draw("colz");
-        // c1->SaveAs(Form("histograms/%s.png", hist_name.c_str()));
-        c1->SaveAs(Form("%s/%s.png", m_path.c_str(), hist_name.c_str()));
+        SaveHist2D(ptr_hist.get(), m_path);
     }
 }
 
@@ -104,7 +157,7 @@ void HistManager::DrawStack(std::vector<std::string> const& names, std::string c
     { 
         try
         {
-            auto const& [ptr_hist, hist_info] = m_hists_1d.at(name); 
+            auto const& [ptr_hist, hist_info] = m_hists_1d[m_index_1d.at(name)]; 
             auto const& [title, labels, range, nbins] = hist_info;
             auto const& [xlabel, ylabel] = labels;
 
@@ -133,15 +186,41 @@ void HistManager::DrawStack(std::vector<std::string> const& names, std::string c
 
 void HistManager::Reset()
 {
-    for (auto const& [hist_name, hhi_pair]: m_hists_1d)
+    for (auto const& [ptr_hist, hist_info]: m_hists_1d)
     {
-        auto const& [ptr_hist, hist_info] = hhi_pair;
         ptr_hist->Reset("ICESM");
     }
 
-    for (auto const& [hist_name, hhi_pair]: m_hists_2d)
+    for (auto const& [ptr_hist, hist_info]: m_hists_2d)
     {
-        auto const& [ptr_hist, hist_info] = hhi_pair;
         ptr_hist->Reset("ICESM");
     }
+}
+
+void SaveHist1D(TH1* hist, std::string const& path)
+{
+    auto c1 = std::make_unique<TCanvas>("c1", "c1");
+    c1->SetGrid();
+    c1->SetTickx();
+    c1->SetTicky();
+
+    hist->SetLineWidth(3);
+    hist->SetStats(1);
+    hist->Draw();
+    c1->SaveAs(Form("%s/%s.png", path.c_str(), hist->GetName()));
+}
+
+void SaveHist2D(TH2* hist, std::string const& path)
+{
+    auto c1 = std::make_unique<TCanvas>("c1", "c1");
+    c1->SetGrid();
+    c1->SetTickx();
+    c1->SetTicky();
+
+    auto gStyle = std::make_unique<TStyle>();
+    gStyle->SetPalette(kRainBow);
+
+    hist->SetStats(0);
+    hist->Draw("colz");
+    c1->SaveAs(Form("%s/%s.png", path.c_str(), hist->GetName()));
 }
\ No newline at end of file
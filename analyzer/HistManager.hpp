@@ -2,12 +2,30 @@
 #define HIST_MAN_HPP
 
 #include <unordered_map>
+#include <vector>
+#include <string>
 #include <memory>
 #include <tuple>
 
 #include "TH1.h"
 #include "TH2.h"
 
+// returned by HistManager::Add, filling by handle is one indexed access into the array of histograms, name is not hashed
+// handles are made only by HistManager::Add, so every handle refers to a registered histogram
+class Hist1DHandle
+{
+    friend class HistManager;
+    explicit Hist1DHandle(int i) : idx(i) {}
+    int idx;
+};
+
+class Hist2DHandle
+{
+    friend class HistManager;
+    explicit Hist2DHandle(int i) : idx(i) {}
+    int idx;
+};
+
 class HistManager
 {
     private:
@@ -54,10 +72,14 @@ class HistManager
         return {title, labels, xrange, yrange, bins};
     }
 
+    // histograms are owned by the manager and not attached to the current directory,
+    // so they may be booked before TH1::AddDirectory(false), e.g. in member initializers
     inline std::unique_ptr<TH1F> Make1DHist(std::string const& name, std::string const& title, Range const& range, int n_bins)
     {
         auto const& [min, max] = range;
-        return std::make_unique<TH1F>(name.data(), title.data(), n_bins, min, max);
+        auto hist = std::make_unique<TH1F>(name.data(), title.data(), n_bins, min, max);
+        hist->SetDirectory(nullptr);
+        return hist;
     }
 
     inline std::unique_ptr<TH2F> Make2DHist(std::string const& name, std::string const& title, Range const& xrange, Range const& yrange, Bins const& bins)
@@ -65,7 +87,9 @@ class HistManager
         auto const& [xmin, xmax] = xrange;
         auto const& [ymin, ymax] = yrange;
         auto const& [xbins, ybins] = bins;
-        return std::make_unique<TH2F>(name.data(), title.data(), xbins, xmin, xmax, ybins, ymin, ymax);
+        auto hist = std::make_unique<TH2F>(name.data(), title.data(), xbins, xmin, xmax, ybins, ymin, ymax);
+        hist->SetDirectory(nullptr);
+        return hist;
     }
 
     inline Item1D MakeItem1D(std::string const& hist_name, std::string const& title, Labels const& labels, Range const& range, int n_bins)
@@ -78,21 +102,47 @@ class HistManager
         return {Make2DHist(hist_name, title, xrange, yrange, bins), Make2DInfo(title, labels, xrange, yrange, bins)};
     }
 
-    std::unordered_map<std::string, Item1D> m_hists_1d;
-    std::unordered_map<std::string, Item2D> m_hists_2d;
+    // histograms are stored in order of registration, names map to their positions
+    std::vector<Item1D> m_hists_1d;
+    std::vector<Item2D> m_hists_2d;
+    std::unordered_map<std::string, int> m_index_1d;
+    std::unordered_map<std::string, int> m_index_2d;
     std::string m_path;
 
     public:
     HistManager(std::string path = "histograms");
-    void Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& range, int n_bins);
-    void Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& xrange, Range const& yrange, Bins const& bins);
+    // histogram with already registered name is not replaced, its handle is returned
+    Hist1DHandle Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& range, int n_bins);
+    Hist2DHandle Add(std::string hist_name, std::string const& title, Labels const& labels, Range const& xrange, Range const& yrange, Bins const& bins);
     void Fill(std::string const& hist_name, double value);
     void FillWeighted(std::string const& hist_name, double value, double weight);
     void Fill(std::string const& hist_name, double xval, double yval);
     void FillWeighted(std::string const& hist_name, double xval, double yval, double weight);
+    inline void Fill(Hist1DHandle h, double value) { m_hists_1d[h.idx].first->Fill(value); }
+    inline void Fill(Hist2DHandle h, double xval, double yval) { m_hists_2d[h.idx].first->Fill(xval, yval); }
+    inline void FillWeighted(Hist1DHandle h, double value, double weight) { m_hists_1d[h.idx].first->Fill(value, weight); }
+    inline void FillWeighted(Hist2DHandle h, double xval, double yval, double weight) { m_hists_2d[h.idx].first->Fill(xval, yval, weight); }
+    // n values with unit weights in one call
+    inline void FillN(Hist1DHandle h, double const* values, int n) { m_hists_1d[h.idx].first->FillN(n, values, nullptr); }
+    inline void FillN(Hist1DHandle h, std::vector<double> const& values) { FillN(h, values.data(), values.size()); }
+    inline TH1F const* Get(Hist1DHandle h) const { return m_hists_1d[h.idx].first.get(); }
+    inline TH2F const* Get(Hist2DHandle h) const { return m_hists_2d[h.idx].first.get(); }
+
+    // empty histograms with the same registrations, handles of this manager are valid for the shard
+    // shards are made before threads start, every thread fills its own shard without locks (see HistShards)
+    HistManager MakeShard() const;
+    // adds bin contents and statistics of shard made by MakeShard
+    void Merge(HistManager const& shard);
+    // all histograms with axis titles in one compressed ROOT file, written at the end of a run instead of drawing
+    // PNGs are made from the file by render_hists only when needed
+    void Write(std::string const& file_name) const;
     void Draw() const;
     void DrawStack(std::vector<std::string> const& names, std::string const& title, std::string const& name) const;
     void Reset();
 };
 
+// PNG of one histogram in path/<name>.png, axis titles are taken from the histogram
+void SaveHist1D(TH1* hist, std::string const& path);
+void SaveHist2D(TH2* hist, std::string const& path);
+
 #endif
\ No newline at end of file
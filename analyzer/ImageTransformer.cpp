@@ -1,137 +1,180 @@
 #include "ImageTransformer.hpp"
 
+#include <cmath>
+#include <algorithm>
 
-ImageTransformer::ImageTransformer(TString output_name)
-:   m_output(std::make_unique<TFile>(output_name, "RECREATE"))
-,   m_tree(std::make_unique<TTree>("img_tree", "img_tree"))
+namespace
 {
-    ResetImgArr(m_img_en);
-    ResetImgArr(m_img_px);
-    ResetImgArr(m_img_py);
-    ResetImgArr(m_img_pz);
-    m_tree->Branch("image_en", m_img_en, "m_img_en[NUM_PIX][NUM_PIX]/F");
-    m_tree->Branch("image_px", m_img_px, "m_img_px[NUM_PIX][NUM_PIX]/F");
-    m_tree->Branch("image_py", m_img_py, "m_img_py[NUM_PIX][NUM_PIX]/F");
-    m_tree->Branch("image_pz", m_img_pz, "m_img_pz[NUM_PIX][NUM_PIX]/F");
+    constexpr double PI = 3.14159265358979323846;
 }
 
-void ImageTransformer::ResetImgArr(Float_t img[NUM_PIX][NUM_PIX])
+ImageTransformer::ImageTransformer(TString output_name)
+:   m_pix_row(MAX_IMG_PIX)
+,   m_pix_col(MAX_IMG_PIX)
+,   m_pix_en(MAX_IMG_PIX)
+,   m_pix_px(MAX_IMG_PIX)
+,   m_pix_py(MAX_IMG_PIX)
+,   m_pix_pz(MAX_IMG_PIX)
+,   m_slot(MAX_IMG_PIX, -1)
+,   m_output(std::make_unique<TFile>(output_name, "RECREATE"))
+,   m_tree(std::make_unique<TTree>("img_tree", "img_tree"))
 {
-    for (size_t r = 0; r < NUM_PIX; ++r)
+    for (size_t c = 0; c < NUM_PIX; ++c)
     {
-        for (size_t c = 0; c < NUM_PIX; ++c)
+        auto [phi, eta] = FindPixelPos(ZERO_PIX, c);
+        if (phi > PI)
         {
-            img[r][c] = 0.0;
+            phi -= 2.0*PI;
         }
+        else if (phi < -PI)
+        {
+            phi += 2.0*PI;
+        }
+        m_wrap_col[c] = FindPixelIdx(phi, eta).second;
     }
+
+    m_tree->Branch("n_pix", &m_n_pix, "n_pix/I");
+    m_tree->Branch("pix_row", m_pix_row.data(), "pix_row[n_pix]/S");
+    m_tree->Branch("pix_col", m_pix_col.data(), "pix_col[n_pix]/S");
+    m_tree->Branch("pix_en", m_pix_en.data(), "pix_en[n_pix]/F");
+    m_tree->Branch("pix_px", m_pix_px.data(), "pix_px[n_pix]/F");
+    m_tree->Branch("pix_py", m_pix_py.data(), "pix_py[n_pix]/F");
+    m_tree->Branch("pix_pz", m_pix_pz.data(), "pix_pz[n_pix]/F");
 }
 
-std::pair<size_t, size_t> ImageTransformer::FindPixelIdx(Float_t x, Float_t y)
+// tree is owned by output file once written, so it is deleted before the file is closed
+ImageTransformer::~ImageTransformer()
 {
-    size_t x_disp = std::abs(static_cast<int>(x/PIXEL_SZ));
-    size_t col = x < 0.0 ? ZERO_PIX - x_disp : ZERO_PIX + x_disp;
-    size_t y_disp = std::abs(static_cast<int>(y/PIXEL_SZ));
-    size_t row = y < 0.0 ? ZERO_PIX - y_disp : ZERO_PIX + y_disp;
+    m_output->cd();
+    m_tree->Write();
+    m_tree.reset();
+    m_output->Close();
+}
+
+// x is phi, y is eta; pixel i covers [(i - ZERO_PIX - 0.5)*PIXEL_SZ, (i - ZERO_PIX + 0.5)*PIXEL_SZ)
+std::pair<int, int> ImageTransformer::FindPixelIdx(Float_t x, Float_t y) const
+{
+    int col = static_cast<int>(ZERO_PIX) + static_cast<int>(std::floor(x/PIXEL_SZ + 0.5));
+    int row = static_cast<int>(ZERO_PIX) + static_cast<int>(std::floor(y/PIXEL_SZ + 0.5));
     return {row, col};
 }
 
-std::pair<Float_t, Float_t> ImageTransformer::FindPixelPos(size_t i, size_t j)
+std::pair<Float_t, Float_t> ImageTransformer::FindPixelPos(size_t i, size_t j) const
 {
     Float_t y = -1.0*HALF_LEN + PIXEL_SZ/2.0 + PIXEL_SZ*i;
     Float_t x = -1.0*HALF_LEN + PIXEL_SZ/2.0 + PIXEL_SZ*j;
     return {x, y};
 }
 
-void ImageTransformer::ImageP4(LorentzVectorF_t const& p4, Float_t radius)
+ImageTransformer::Stencil const& ImageTransformer::GetStencil(Float_t radius)
 {
-    Float_t phi = p4.Phi();
-    Float_t eta = p4.Eta();
-    Float_t r2 = radius*radius;
-
-    auto [row, col] = FindPixelIdx(phi, eta);
-    
-    if (radius > 0.0)
+    auto [it, inserted] = m_stencils.insert({radius, {}});
+    if (inserted)
     {
-        // draw object of non-zero radius
-        Float_t min_phi = phi - radius;
-        Float_t min_eta = eta - radius;
-
-        // at first need to count all pixels that need to be painted
-        size_t n = static_cast<size_t>(radius/PIXEL_SZ);
-        size_t num_steps = 2*n + 1;
-        int filled_pixel_count = 0;
-        for (size_t i = 0; i < num_steps; ++i)
+        // pixel centers within radius of the center of the central pixel, compared in units of pixels,
+        // tolerance keeps pixels exactly on the circle despite rounding of radius/PIXEL_SZ
+        double r_pix = radius/PIXEL_SZ;
+        double r2_pix = r_pix*r_pix + 1e-3;
+        int n = static_cast<int>(r_pix) + 1;
+        for (int dr = -n; dr <= n; ++dr)
         {
-            Float_t cur_eta = min_eta + i*PIXEL_SZ;
-            if (std::abs(cur_eta) > HALF_LEN)
-            {
-                continue;
-            }
-
-            for (size_t j = 0; j < num_steps; ++j)
+            for (int dc = -n; dc <= n; ++dc)
             {
-                Float_t cur_phi = min_phi + j*PIXEL_SZ;
-                Float_t dsit2 = (cur_phi - phi)*(cur_phi - phi) + (cur_eta - eta)*(cur_eta - eta);
-                if (dsit2 <= r2)
+                if (dr*dr + dc*dc <= r2_pix)
                 {
-                    // count this pixel
-                    ++filled_pixel_count;
+                    it->second.push_back({dr, dc});
                 }
             }
         }
+    }
+    return it->second;
+}
 
-        // paint pixels in separate loop
-        // don't know how to optimize it yet
-        for (size_t i = 0; i < num_steps; ++i)
-        {
-            Float_t cur_eta = min_eta + i*PIXEL_SZ;
-            if (std::abs(cur_eta) > HALF_LEN)
-            {
-                continue;
-            }
+void ImageTransformer::ImageP4(LorentzVectorF_t const& p4, Float_t radius)
+{
+    auto [row, col] = FindPixelIdx(p4.Phi(), p4.Eta());
+    int const n_pix = NUM_PIX;
 
-            for (size_t j = 0; j < num_steps; ++j)
-            {
-                Float_t cur_phi = min_phi + j*PIXEL_SZ;
-                Float_t dsit2 = (cur_phi - phi)*(cur_phi - phi) + (cur_eta - eta)*(cur_eta - eta);
-                if (dsit2 <= r2)
-                {
-                    auto [r, c] = FindPixelIdx(cur_eta, cur_phi); // this function needs to be fixed; now it does UB
-                    m_img_en[r][c] += p4.E();
-                    m_img_px[r][c] += p4.Px();
-                    m_img_py[r][c] += p4.Py();
-                    m_img_pz[r][c] += p4.Pz();
-                }
-            }
+    m_disk.clear();
+    for (auto const& [dr, dc]: GetStencil(radius))
+    {
+        int r = row + dr;
+        int c = col + dc;
+        if (r < 0 || r >= n_pix || c < 0 || c >= n_pix)
+        {
+            continue;
         }
+        m_disk.push_back(r*n_pix + m_wrap_col[c]);
+    }
 
-        // size_t dn = static_cast<size_t>(radius/PIXEL_SZ)
-
-        // size_t min_row = row > dn ? row - dn : 0;
-        // size_t max_row = row + dn < NUM_PIX ? row + dn : NUM_PIX;
+    if (m_disk.empty())
+    {
+        return;
+    }
 
-        // int filled_pixel_count = 0;
-        // for (size_t r = min_row; r < max_row; ++r)
-        // {
-        //     for (size_t c = 0; c < n_pix; ++c)
-        //     {
+    Float_t share = 1.0/m_disk.size();
+    std::array<Float_t, 4> p4_share = {share*p4.E(), share*p4.Px(), share*p4.Py(), share*p4.Pz()};
+    for (int pix: m_disk)
+    {
+        int& slot = m_slot[pix];
+        if (slot == -1)
+        {
+            slot = m_acc.size();
+            m_acc.push_back({0.0, 0.0, 0.0, 0.0});
+            m_touched.push_back(pix);
+        }
 
-        //     }
-        // }
+        auto& acc = m_acc[slot];
+        for (size_t k = 0; k < acc.size(); ++k)
+        {
+            acc[k] += p4_share[k];
+        }
     }
-    else 
+}
+
+void ImageTransformer::FlushImage()
+{
+    std::sort(m_touched.begin(), m_touched.end());
+    m_n_pix = m_touched.size();
+    for (int k = 0; k < m_n_pix; ++k)
     {
-        // draw object of radius size (i.e. 1 pixel)
-        m_img_en[row][col] += p4.E();
-        m_img_px[row][col] += p4.Px();
-        m_img_py[row][col] += p4.Py();
-        m_img_pz[row][col] += p4.Pz();
+        int pix = m_touched[k];
+        auto const& acc = m_acc[m_slot[pix]];
+        m_pix_row[k] = pix/NUM_PIX;
+        m_pix_col[k] = pix%NUM_PIX;
+        m_pix_en[k] = acc[0];
+        m_pix_px[k] = acc[1];
+        m_pix_py[k] = acc[2];
+        m_pix_pz[k] = acc[3];
+        m_slot[pix] = -1;
     }
-} 
+
+    m_tree->Fill();
+    m_touched.clear();
+    m_acc.clear();
+}
 
 void ImageTransformer::Transform(Storage const& storage, TTree* tree, int evt)
 {
     tree->GetEntry(evt);
-    // TODO
-    m_tree->Fill();
-}
\ No newline at end of file
+
+    for (int i = 0; i < storage.n_reco_jet; ++i)
+    {
+        LorentzVectorF_t jet(storage.reco_jet_pt[i], storage.reco_jet_eta[i], storage.reco_jet_phi[i], storage.reco_jet_mass[i]);
+        ImageP4(jet, JET_IMG_RADIUS);
+    }
+
+    for (size_t i = 0; i < MAX_RECO_LEP; ++i)
+    {
+        if (storage.reco_lep_pt[i] > 0.0)
+        {
+            LorentzVectorF_t lep(storage.reco_lep_pt[i], storage.reco_lep_eta[i], storage.reco_lep_phi[i], storage.reco_lep_mass[i]);
+            ImageP4(lep);
+        }
+    }
+
+    LorentzVectorF_t met(storage.reco_met_pt, 0.0, storage.reco_met_phi, 0.0);
+    ImageP4(met);
+
+    FlushImage();
+}
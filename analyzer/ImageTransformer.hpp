@@ -1,6 +1,12 @@
 #ifndef IMG_TFMR_HPP
 #define IMG_TFMR_HPP
 
+#include <map>
+#include <vector>
+#include <array>
+#include <memory>
+#include <utility>
+
 #include "Storage.hpp"
 
 #include "TH2F.h"
@@ -13,25 +19,59 @@ inline constexpr Float_t PIXEL_SZ = 0.04;
 inline constexpr size_t CNT = static_cast<size_t>(2*HALF_LEN/PIXEL_SZ);
 inline constexpr size_t NUM_PIX = CNT % 2 == 0 ? CNT + 1 : CNT;
 inline constexpr size_t ZERO_PIX = (NUM_PIX - 1)/2;
+inline constexpr size_t MAX_IMG_PIX = NUM_PIX*NUM_PIX;
+// radius of disk painted for a reco jet, leptons and MET are single pixels
+inline constexpr Float_t JET_IMG_RADIUS = 0.4;
 
-class ImageTransformer 
+// event image in (eta, phi) plane: rows are eta, columns are phi, pixel ZERO_PIX is centered at 0
+// objects are painted as disks, 4-momentum of object is shared equally between pixels of its disk inside the image
+// disks are clipped at image border in eta and wrap around in phi
+// image is stored sparse in COO format: n_pix non-empty pixels sorted by row, then by column,
+// so row pointers of CSR format are obtained by counting pixels per row
+class ImageTransformer
 {
     public:
     ImageTransformer(TString output_name);
+    // writes image tree and closes output file
+    ~ImageTransformer();
+    ImageTransformer(ImageTransformer const&) = delete;
+    ImageTransformer& operator=(ImageTransformer const&) = delete;
+
     void Transform(Storage const& storage, TTree* tree, int evt);
 
     private:
-    Float_t m_img_en[NUM_PIX][NUM_PIX];
-    Float_t m_img_px[NUM_PIX][NUM_PIX];
-    Float_t m_img_py[NUM_PIX][NUM_PIX];
-    Float_t m_img_pz[NUM_PIX][NUM_PIX];
+    using Stencil = std::vector<std::pair<int, int>>;
+
+    Int_t m_n_pix = 0;
+    // output buffers have room for the full image, only first m_n_pix entries are written
+    std::vector<Short_t> m_pix_row;
+    std::vector<Short_t> m_pix_col;
+    std::vector<Float_t> m_pix_en;
+    std::vector<Float_t> m_pix_px;
+    std::vector<Float_t> m_pix_py;
+    std::vector<Float_t> m_pix_pz;
+
+    // accumulation of current event: m_slot[row*NUM_PIX + col] is position of pixel in m_acc or -1,
+    // only touched entries are reset, so an event costs its number of painted pixels
+    std::vector<int> m_slot;
+    std::vector<int> m_touched;
+    std::vector<std::array<Float_t, 4>> m_acc;
+    std::vector<int> m_disk;
+
+    // (row, col) offsets of pixels within radius of the center pixel, built once per radius
+    std::map<Float_t, Stencil> m_stencils;
+    // column of pixel with phi wrapped into [-pi, pi]
+    std::array<int, NUM_PIX> m_wrap_col;
+
     std::unique_ptr<TFile> m_output;
     std::unique_ptr<TTree> m_tree;
 
-    void ResetImgArr(Float_t img[NUM_PIX][NUM_PIX]);
+    Stencil const& GetStencil(Float_t radius);
     void ImageP4(LorentzVectorF_t const& p4, Float_t radius = 0.0);
-    std::pair<size_t, size_t> FindPixelIdx(Float_t x, Float_t y);
-    std::pair<Float_t, Float_t> FindPixelPos(size_t i, size_t j);
+    void FlushImage();
+    // may be outside of [0, NUM_PIX)
+    std::pair<int, int> FindPixelIdx(Float_t x, Float_t y) const;
+    std::pair<Float_t, Float_t> FindPixelPos(size_t i, size_t j) const;
 };
 
-#endif
\ No newline at end of file
+#endif
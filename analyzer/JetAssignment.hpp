@@ -0,0 +1,127 @@
+#ifndef JET_ASSIGNMENT_HPP
+#define JET_ASSIGNMENT_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "DeltaRMatrix.hpp"
+
+// quark is matched to jet within this cone
+inline constexpr double MAX_MATCH_DR = 0.4;
+
+// jets[p] is index of jet matched to parton p or -1, cost is sum of dR of matched pairs
+struct Assignment
+{
+    std::vector<int> jets;
+    int n_matched = 0;
+    double cost = 0.0;
+
+    inline bool IsComplete() const { return n_matched == static_cast<int>(jets.size()); }
+};
+
+// global matching of partons to distinct jets within max_dr:
+// maximizes number of matched partons, then minimizes sum of dR
+// unlike matching every parton to its closest jet, two partons closest to the same jet do not make the event unmatched
+// exhaustive depth-first search over candidates of every parton sorted by dR,
+// branch is pruned when it can not match more partons or can only have larger cost than the best assignment found
+// intended for a few partons (b and light quarks), number of candidates in the cone is small
+class AssignmentSolver
+{
+    public:
+    // rows of dr are partons, columns are jets
+    Assignment Solve(DeltaRMatrix const& dr, double max_dr = MAX_MATCH_DR)
+    {
+        int n_partons = dr.NumRows();
+        int n_jets = dr.NumCols();
+        float max_dr2 = max_dr*max_dr;
+
+        m_candidates.assign(n_partons, {});
+        m_min_cost.assign(n_partons + 1, 0.0);
+        for (int p = 0; p < n_partons; ++p)
+        {
+            auto& cand = m_candidates[p];
+            for (int j = 0; j < n_jets; ++j)
+            {
+                if (dr.DR2(p, j) < max_dr2)
+                {
+                    cand.push_back(j);
+                }
+            }
+            std::sort(cand.begin(), cand.end(), [&dr, p](int j1, int j2) { return dr.DR2(p, j1) < dr.DR2(p, j2); });
+        }
+
+        // cost of partons p, p + 1, ... is at least sum of their smallest dR
+        for (int p = n_partons - 1; p >= 0; --p)
+        {
+            m_min_cost[p] = m_min_cost[p + 1] + (m_candidates[p].empty() ? 0.0 : dr.DR(p, m_candidates[p].front()));
+        }
+
+        m_used.assign(n_jets, false);
+        m_current.assign(n_partons, -1);
+        m_best = Assignment{std::vector<int>(n_partons, -1), 0, 0.0};
+        m_best_found = false;
+        Search(dr, 0, 0, 0.0);
+        return m_best;
+    }
+
+    private:
+    void Search(DeltaRMatrix const& dr, int p, int n_matched, double cost)
+    {
+        int n_partons = m_current.size();
+        if (p == n_partons)
+        {
+            if (!m_best_found || n_matched > m_best.n_matched || (n_matched == m_best.n_matched && cost < m_best.cost))
+            {
+                m_best.jets = m_current;
+                m_best.n_matched = n_matched;
+                m_best.cost = cost;
+                m_best_found = true;
+            }
+            return;
+        }
+
+        int max_matched = n_matched;
+        for (int q = p; q < n_partons; ++q)
+        {
+            max_matched += !m_candidates[q].empty();
+        }
+        if (m_best_found && (max_matched < m_best.n_matched || (max_matched == m_best.n_matched && cost + m_min_cost[p] >= m_best.cost)))
+        {
+            return;
+        }
+
+        for (int j: m_candidates[p])
+        {
+            if (!m_used[j])
+            {
+                m_used[j] = true;
+                m_current[p] = j;
+                Search(dr, p + 1, n_matched + 1, cost + dr.DR(p, j));
+                m_used[j] = false;
+            }
+        }
+
+        m_current[p] = -1;
+        Search(dr, p + 1, n_matched, cost);
+    }
+
+    std::vector<std::vector<int>> m_candidates;
+    std::vector<double> m_min_cost;
+    std::vector<bool> m_used;
+    std::vector<int> m_current;
+    Assignment m_best;
+    bool m_best_found = false;
+};
+
+// dR matrix and optimal assignment in one call
+template <typename PartonVec, typename JetVec>
+Assignment MatchPartons(std::vector<PartonVec> const& partons, std::vector<JetVec> const& jets, double max_dr = MAX_MATCH_DR)
+{
+    DeltaRMatrix dr;
+    dr.Fill(partons, jets);
+    AssignmentSolver solver;
+    return solver.Solve(dr, max_dr);
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef MATCH_TREE_HPP
+#define MATCH_TREE_HPP
+
+#include <array>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+#include "TTree.h"
+#include "TFriendElement.h"
+#include "TString.h"
+
+#include "Constants.hpp"
+#include "JetAssignment.hpp"
+
+// gen quark to reco jet (centralJet) matching is computed once by matching/match_tree
+// and stored next to input file in a friend tree with one entry per entry of the input tree
+inline constexpr char MATCH_TREE_NAME[] = "Matches";
+// longest label is b19b19q19q19
+inline constexpr size_t MATCH_LABEL_SIZE = 16;
+
+// nano_sl_M800.root -> nano_sl_M800_match_sl.root
+inline TString MatchFileName(TString const& input_name, Channel ch)
+{
+    TString name = input_name;
+    if (name.EndsWith(".root"))
+    {
+        name.Remove(name.Length() - 5);
+    }
+    name += ch == Channel::SL ? "_match_sl.root" : "_match_dl.root";
+    return name;
+}
+
+// matched quarks are b1, b2 in DL channel and b1, b2, q1, q2 in SL channel
+// to ensure compatibility with how label of any combination is formed
+// indices of matched reco b jets and of matched reco light jets are organized lexicographically
+// label is empty if any quark has no match
+inline TString MakeTrueLabel(Assignment const& match)
+{
+    if (!match.IsComplete())
+    {
+        return {};
+    }
+
+    int b1_match = match.jets[static_cast<size_t>(Quark::b1)];
+    int b2_match = match.jets[static_cast<size_t>(Quark::b2)];
+    if (match.jets.size() == NUM_BQ)
+    {
+        return Form("b%db%d", std::min(b1_match, b2_match), std::max(b1_match, b2_match));
+    }
+
+    if (match.jets.size() == static_cast<size_t>(Quark::count))
+    {
+        int q1_match = match.jets[static_cast<size_t>(Quark::q1)];
+        int q2_match = match.jets[static_cast<size_t>(Quark::q2)];
+        return Form("b%db%dq%dq%d", std::min(b1_match, b2_match), std::max(b1_match, b2_match), std::min(q1_match, q2_match), std::max(q1_match, q2_match));
+    }
+
+    return {};
+}
+
+// matching of one event as stored in the friend tree
+struct MatchRecord
+{
+    ULong64_t event = 0;
+    Int_t n_quarks = 0;
+    Int_t n_matched = 0;
+    // index of reco jet matched to quark in Quark order, -1 if quark is not matched
+    std::array<Short_t, MAX_GEN_QUARK> jet = {0};
+    // dR between quark and matched jet, -1 if quark is not matched
+    std::array<Float_t, MAX_GEN_QUARK> dr = {0.0};
+    // MakeTrueLabel of the matching
+    char label[MATCH_LABEL_SIZE] = "";
+
+    inline bool IsComplete() const { return n_matched == n_quarks; }
+
+    // rows of dr_matrix are quarks in Quark order, columns are reco jets
+    void Set(ULong64_t event_id, Assignment const& match, DeltaRMatrix const& dr_matrix)
+    {
+        event = event_id;
+        n_quarks = match.jets.size();
+        n_matched = match.n_matched;
+        for (int q = 0; q < n_quarks; ++q)
+        {
+            int j = match.jets[q];
+            jet[q] = j;
+            dr[q] = j != -1 ? dr_matrix.DR(q, j) : -1.0;
+        }
+
+        TString true_label = MakeTrueLabel(match);
+        std::strncpy(label, true_label.Data(), MATCH_LABEL_SIZE - 1);
+        label[MATCH_LABEL_SIZE - 1] = '\0';
+    }
+
+    Assignment ToAssignment() const
+    {
+        Assignment match{std::vector<int>(jet.begin(), jet.begin() + n_quarks), n_matched, 0.0};
+        for (int q = 0; q < n_quarks; ++q)
+        {
+            match.cost += jet[q] != -1 ? dr[q] : 0.0;
+        }
+        return match;
+    }
+
+    void Branch(TTree* tree)
+    {
+        tree->Branch("event", &event, "event/l");
+        tree->Branch("n_quarks", &n_quarks, "n_quarks/I");
+        tree->Branch("n_matched", &n_matched, "n_matched/I");
+        tree->Branch("quark_jet", jet.data(), "quark_jet[n_quarks]/S");
+        tree->Branch("quark_dr", dr.data(), "quark_dr[n_quarks]/F");
+        tree->Branch("true_label", label, "true_label/C");
+    }
+
+    // prefix is alias of friend tree followed by a dot
+    void Connect(TTree* tree, TString const& prefix)
+    {
+        tree->SetBranchAddress(prefix + "event", &event);
+        tree->SetBranchAddress(prefix + "n_quarks", &n_quarks);
+        tree->SetBranchAddress(prefix + "n_matched", &n_matched);
+        tree->SetBranchAddress(prefix + "quark_jet", jet.data());
+        tree->SetBranchAddress(prefix + "quark_dr", dr.data());
+        tree->SetBranchAddress(prefix + "true_label", label);
+    }
+};
+
+// adds matching of input file for channel ch as friend of tree and connects record to it
+// friend is aliased Matches_sl or Matches_dl, so both channels can be attached to the same tree
+// returns false if there is no match file, then caller matches on the fly
+inline bool AttachMatchTree(TTree* tree, TString const& input_name, Channel ch, MatchRecord& record)
+{
+    TString match_name = MatchFileName(input_name, ch);
+    if (!std::filesystem::exists(match_name.Data()))
+    {
+        return false;
+    }
+
+    TString alias = TString(MATCH_TREE_NAME) + (ch == Channel::SL ? "_sl" : "_dl");
+    TFriendElement* fe = tree->AddFriend(alias + "=" + MATCH_TREE_NAME, match_name);
+    TTree* friend_tree = fe ? fe->GetTree() : nullptr;
+    if (!friend_tree)
+    {
+        throw std::runtime_error("Unable to read " + std::string(MATCH_TREE_NAME) + " from " + match_name.Data());
+    }
+
+    if (friend_tree->GetEntries() != tree->GetEntries())
+    {
+        throw std::runtime_error(std::string(match_name.Data()) + " does not match " + input_name.Data() + ", rerun match_tree");
+    }
+
+    record.Connect(tree, alias + ".");
+    return true;
+}
+
+#endif
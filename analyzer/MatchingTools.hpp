@@ -7,9 +7,7 @@
 
 int MatchIdx(LorentzVectorF_t const& parton, VecLVF_t const& jets);
 
-// to ensure compatibility with how label of any combination is formed
-// will organize indices of matched reco b jets lexicographically
-// will organize indices of matched reco light jets lexicographically
+// quarks are matched to distinct jets globally (see JetAssignment.hpp), label is formed as in MatchTree.hpp
 TString MakeTrueLabel(VecLVF_t const& gen, VecLVF_t const& reco);
 inline bool IsTrue(TString const& true_label, TString const& label) { return true_label == label; }
 
@@ -0,0 +1,169 @@
+#ifndef P2_QUANTILE_HPP
+#define P2_QUANTILE_HPP
+
+#include <array>
+#include <cmath>
+
+#include "RtypesCore.h"
+
+// streaming estimate of a single quantile with P^2 algorithm (Jain, Chlamtac 1985)
+// keeps 5 markers: O(1) memory and O(1) update, no histogram is needed
+// weighted samples: marker positions are cumulative weights instead of ranks (as in weighted P^2 of Boost.Accumulators),
+// markers move in steps of unit weight, so weights are expected to be of order 1; unit weights give plain P^2
+class P2Quantile
+{
+    public:
+    explicit P2Quantile(Float_t p)
+    :   m_p(p)
+    ,   m_dn{0.0f, p/2.0f, p, (1.0f + p)/2.0f, 1.0f}
+    {
+        Reset();
+    }
+
+    inline void Reset()
+    {
+        m_count = 0;
+    }
+
+    inline void Add(Float_t x, Float_t w = 1.0f)
+    {
+        if (m_count < 5)
+        {
+            m_q[m_count] = x;
+            m_w[m_count] = w;
+            ++m_count;
+            if (m_count == 5)
+            {
+                InsertionSort(m_q, m_w, 5);
+                // positions relative to the lowest marker, {0, 1, 2, 3, 4} for unit weights
+                m_n[0] = 0.0f;
+                for (int i = 1; i < 5; ++i)
+                {
+                    m_n[i] = m_n[i - 1] + m_w[i];
+                }
+                for (int i = 0; i < 5; ++i)
+                {
+                    m_np[i] = m_n[4]*m_dn[i];
+                }
+            }
+            return;
+        }
+        ++m_count;
+
+        // find cell containing x and update extreme markers
+        int k = 0;
+        if (x < m_q[0])
+        {
+            m_q[0] = x;
+            k = 0;
+        }
+        else if (x >= m_q[4])
+        {
+            m_q[4] = x;
+            k = 3;
+        }
+        else
+        {
+            k = 0;
+            while (k < 3 && x >= m_q[k + 1])
+            {
+                ++k;
+            }
+        }
+
+        for (int i = k + 1; i < 5; ++i)
+        {
+            m_n[i] += w;
+        }
+        for (int i = 0; i < 5; ++i)
+        {
+            m_np[i] += w*m_dn[i];
+        }
+
+        // adjust middle markers if they are off their desired positions
+        for (int i = 1; i < 4; ++i)
+        {
+            Float_t d = m_np[i] - m_n[i];
+            if ((d >= 1.0f && m_n[i + 1] - m_n[i] > 1.0f) || (d <= -1.0f && m_n[i - 1] - m_n[i] < -1.0f))
+            {
+                int s = d > 0.0f ? 1 : -1;
+                Float_t q = Parabolic(i, s);
+                if (m_q[i - 1] < q && q < m_q[i + 1])
+                {
+                    m_q[i] = q;
+                }
+                else
+                {
+                    m_q[i] = Linear(i, s);
+                }
+                m_n[i] += s;
+            }
+        }
+    }
+
+    // before 5 samples are seen, quantile of stored samples is returned, ignoring their weights
+    inline Float_t Get() const
+    {
+        if (m_count == 0)
+        {
+            return 0.0f;
+        }
+
+        if (m_count < 5)
+        {
+            std::array<Float_t, 5> tmp = m_q;
+            std::array<Float_t, 5> tmp_w = m_w;
+            InsertionSort(tmp, tmp_w, m_count);
+            int idx = static_cast<int>(std::round(m_p*(m_count - 1)));
+            return tmp[idx];
+        }
+
+        return m_q[2];
+    }
+
+    inline int Count() const { return m_count; }
+
+    private:
+    // sorts arr and permutes weights along
+    static inline void InsertionSort(std::array<Float_t, 5>& arr, std::array<Float_t, 5>& weights, int n)
+    {
+        for (int i = 1; i < n; ++i)
+        {
+            Float_t x = arr[i];
+            Float_t w = weights[i];
+            int j = i - 1;
+            while (j >= 0 && arr[j] > x)
+            {
+                arr[j + 1] = arr[j];
+                weights[j + 1] = weights[j];
+                --j;
+            }
+            arr[j + 1] = x;
+            weights[j + 1] = w;
+        }
+    }
+
+    inline Float_t Parabolic(int i, int s) const
+    {
+        Float_t n_prev = m_n[i - 1];
+        Float_t n_cur = m_n[i];
+        Float_t n_next = m_n[i + 1];
+        return m_q[i] + s/(n_next - n_prev)*((n_cur - n_prev + s)*(m_q[i + 1] - m_q[i])/(n_next - n_cur)
+                                           + (n_next - n_cur - s)*(m_q[i] - m_q[i - 1])/(n_cur - n_prev));
+    }
+
+    inline Float_t Linear(int i, int s) const
+    {
+        return m_q[i] + s*(m_q[i + s] - m_q[i])/(m_n[i + s] - m_n[i]);
+    }
+
+    Float_t m_p;
+    int m_count = 0;
+    std::array<Float_t, 5> m_q = {};
+    std::array<Float_t, 5> m_w = {};
+    std::array<Float_t, 5> m_n = {};
+    std::array<Float_t, 5> m_np = {};
+    std::array<Float_t, 5> m_dn;
+};
+
+#endif
@@ -0,0 +1,651 @@
+#include "PDFBundle.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "TAxis.h"
+
+namespace
+{
+    inline size_t Align8(size_t n)
+    {
+        return (n + 7) & ~static_cast<size_t>(7);
+    }
+
+    // same as TMath::BinarySearch: index of the last element <= value
+    // in case of equal elements the first of them is taken
+    inline size_t BinarySearch(size_t n, double const* array, double value)
+    {
+        double const* pos = std::lower_bound(array, array + n, value);
+        if (pos != array + n && *pos == value)
+        {
+            return pos - array;
+        }
+        return pos - array - 1;
+    }
+
+    // Vose's alias method; empty PDFs get a trivial table which is never used
+    void BuildAliasTable(Float_t const* dens, size_t n, Float_t* prob, std::uint32_t* alias)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            total += dens[i];
+        }
+
+        std::vector<double> scaled(n, 1.0);
+        if (total > 0.0)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                scaled[i] = dens[i]*n/total;
+            }
+        }
+
+        std::vector<std::uint32_t> small;
+        std::vector<std::uint32_t> large;
+        for (size_t i = 0; i < n; ++i)
+        {
+            alias[i] = i;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty())
+        {
+            std::uint32_t s = small.back();
+            small.pop_back();
+            std::uint32_t l = large.back();
+            large.pop_back();
+
+            prob[s] = scaled[s];
+            alias[s] = l;
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            (scaled[l] < 1.0 ? small : large).push_back(l);
+        }
+
+        // leftovers are equal to 1 up to rounding
+        for (auto i: large)
+        {
+            prob[i] = 1.0f;
+        }
+        for (auto i: small)
+        {
+            prob[i] = 1.0f;
+        }
+    }
+
+    // quantiles x(k/n_inv), k = 0..n_inv, of monotone cubic Hermite interpolation of CDF given at bin edges
+    // tangents are harmonic means of neighbouring slopes (Fritsch-Butland), which keeps the spline monotone
+    // and flat over empty bins, so no probability leaks into them
+    void BuildInverseCDF(double const* cdf, size_t nbins, double xmin, double xmax, double* inv, size_t n_inv)
+    {
+        if (cdf[nbins] == 0.0)
+        {
+            std::fill(inv, inv + n_inv + 1, xmin);
+            return;
+        }
+
+        double width = (xmax - xmin)/nbins;
+        std::vector<double> slope(nbins);
+        for (size_t i = 0; i < nbins; ++i)
+        {
+            slope[i] = (cdf[i + 1] - cdf[i])/width;
+        }
+
+        std::vector<double> tangent(nbins + 1, 0.0);
+        tangent[0] = slope[0];
+        tangent[nbins] = slope[nbins - 1];
+        for (size_t i = 1; i < nbins; ++i)
+        {
+            if (slope[i - 1] > 0.0 && slope[i] > 0.0)
+            {
+                tangent[i] = 2.0*slope[i - 1]*slope[i]/(slope[i - 1] + slope[i]);
+            }
+        }
+
+        auto spline = [&](size_t i, double t)
+        {
+            double t2 = t*t;
+            double t3 = t2*t;
+            return (2.0*t3 - 3.0*t2 + 1.0)*cdf[i] + (t3 - 2.0*t2 + t)*width*tangent[i]
+                 + (-2.0*t3 + 3.0*t2)*cdf[i + 1] + (t3 - t2)*width*tangent[i + 1];
+        };
+
+        size_t i = 0;
+        for (size_t k = 0; k <= n_inv; ++k)
+        {
+            double u = static_cast<double>(k)/n_inv;
+            while (i < nbins - 1 && (cdf[i + 1] < u || cdf[i + 1] == cdf[i]))
+            {
+                ++i;
+            }
+
+            double lo = 0.0;
+            double hi = 1.0;
+            for (int iter = 0; iter < 40; ++iter)
+            {
+                double mid = 0.5*(lo + hi);
+                if (spline(i, mid) < u)
+                {
+                    lo = mid;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            inv[k] = xmin + (i + 0.5*(lo + hi))*width;
+        }
+    }
+
+    inline size_t AliasSample(Float_t const* prob, std::uint32_t const* alias, size_t n, TRandom* rng)
+    {
+        double u = rng->Rndm()*n;
+        size_t i = std::min(static_cast<size_t>(u), n - 1);
+        return (u - i) < prob[i] ? i : alias[i];
+    }
+}
+
+Float_t PDF1DView::Density(double x) const
+{
+    if (!(x >= xmin && x < xmax))
+    {
+        return 0.0f;
+    }
+    // same bin finding as TAxis::FindFixBin
+    size_t bin = static_cast<size_t>(nbins*(x - xmin)/(xmax - xmin));
+    return dens[std::min<size_t>(bin, nbins - 1)];
+}
+
+double PDF1DView::IntegralWidth() const
+{
+    double width = (xmax - xmin)/nbins;
+    double integral = 0.0;
+    for (size_t i = 0; i < nbins; ++i)
+    {
+        integral += dens[i]*width;
+    }
+    return integral;
+}
+
+double PDF1DView::Sample(TRandom* rng) const
+{
+    if (cdf[nbins] == 0.0)
+    {
+        return 0.0;
+    }
+
+    return Quantile(rng->Rndm());
+}
+
+double PDF1DView::Quantile(double u) const
+{
+    size_t ibin = BinarySearch(nbins, cdf, u);
+    double width = (xmax - xmin)/nbins;
+    double x = xmin + ibin*width;
+    if (u > cdf[ibin])
+    {
+        x += width*(u - cdf[ibin])/(cdf[ibin + 1] - cdf[ibin]);
+    }
+    return x;
+}
+
+double PDF1DView::SampleAlias(TRandom* rng) const
+{
+    if (cdf[nbins] == 0.0)
+    {
+        return 0.0;
+    }
+
+    size_t bin = AliasSample(alias_prob, alias_idx, nbins, rng);
+    double width = (xmax - xmin)/nbins;
+    return xmin + (bin + rng->Rndm())*width;
+}
+
+double PDF1DView::SampleSmooth(TRandom* rng) const
+{
+    if (IsEmpty())
+    {
+        return 0.0;
+    }
+
+    double u = rng->Rndm()*n_inv_cdf;
+    size_t k = std::min<size_t>(u, n_inv_cdf - 1);
+    return inv_cdf[k] + (u - k)*(inv_cdf[k + 1] - inv_cdf[k]);
+}
+
+Float_t PDF1DView::SmoothDensity(double x) const
+{
+    if (IsEmpty() || !(x >= inv_cdf[0] && x < inv_cdf[n_inv_cdf]))
+    {
+        return 0.0f;
+    }
+
+    // inv_cdf[k] <= x < inv_cdf[k + 1], the interval is never empty
+    size_t k = std::upper_bound(inv_cdf, inv_cdf + n_inv_cdf + 1, x) - inv_cdf - 1;
+    return 1.0/(n_inv_cdf*(inv_cdf[k + 1] - inv_cdf[k]));
+}
+
+Float_t PDF2DView::Density(double x, double y) const
+{
+    if (!(x >= xmin && x < xmax && y >= ymin && y < ymax))
+    {
+        return 0.0f;
+    }
+    size_t binx = std::min<size_t>(nbins_x*(x - xmin)/(xmax - xmin), nbins_x - 1);
+    size_t biny = std::min<size_t>(nbins_y*(y - ymin)/(ymax - ymin), nbins_y - 1);
+    return dens[biny*nbins_x + binx];
+}
+
+void PDF2DView::Sample(double& x, double& y, TRandom* rng) const
+{
+    size_t nbins = static_cast<size_t>(nbins_x)*nbins_y;
+    if (cdf[nbins] == 0.0)
+    {
+        x = 0.0;
+        y = 0.0;
+        return;
+    }
+
+    // same order of random numbers as TH2::GetRandom2
+    double u1 = rng->Rndm();
+    double u2 = rng->Rndm();
+    Quantile(u1, u2, x, y);
+}
+
+void PDF2DView::Quantile(double u1, double u2, double& x, double& y) const
+{
+    size_t nbins = static_cast<size_t>(nbins_x)*nbins_y;
+    size_t ibin = BinarySearch(nbins, cdf, u1);
+    size_t biny = ibin/nbins_x;
+    size_t binx = ibin - nbins_x*biny;
+
+    double xwidth = (xmax - xmin)/nbins_x;
+    double ywidth = (ymax - ymin)/nbins_y;
+    x = xmin + binx*xwidth;
+    if (u1 > cdf[ibin])
+    {
+        x += xwidth*(u1 - cdf[ibin])/(cdf[ibin + 1] - cdf[ibin]);
+    }
+    y = ymin + biny*ywidth + ywidth*u2;
+}
+
+void PDF2DView::SampleAlias(double& x, double& y, TRandom* rng) const
+{
+    size_t nbins = static_cast<size_t>(nbins_x)*nbins_y;
+    if (cdf[nbins] == 0.0)
+    {
+        x = 0.0;
+        y = 0.0;
+        return;
+    }
+
+    size_t bin = AliasSample(alias_prob, alias_idx, nbins, rng);
+    size_t biny = bin/nbins_x;
+    size_t binx = bin - nbins_x*biny;
+    x = xmin + (binx + rng->Rndm())*(xmax - xmin)/nbins_x;
+    y = ymin + (biny + rng->Rndm())*(ymax - ymin)/nbins_y;
+}
+
+double PDF2DView::SampleX(double y, TRandom* rng) const
+{
+    if (IsEmpty())
+    {
+        return 0.0;
+    }
+
+    // NaN goes to the first row
+    double pos = nbins_y*(y - ymin)/(ymax - ymin);
+    size_t row = pos > 0.0 ? std::min<size_t>(pos, nbins_y - 1) : 0;
+
+    size_t offset = row*nbins_x;
+    size_t bin = AliasSample(row_alias_prob + offset, row_alias_idx + offset, nbins_x, rng);
+    return xmin + (bin + rng->Rndm())*(xmax - xmin)/nbins_x;
+}
+
+
+PDFBundle::~PDFBundle()
+{
+    Release();
+}
+
+PDFBundle::PDFBundle(PDFBundle&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+PDFBundle& PDFBundle::operator=(PDFBundle&& other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        // moving the vector keeps its buffer, so m_data stays valid
+        m_storage = std::move(other.m_storage);
+        m_map = other.m_map;
+        m_data = other.m_data;
+        m_size = other.m_size;
+
+        other.m_storage.clear();
+        other.m_map = nullptr;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+void PDFBundle::Release()
+{
+    if (m_map)
+    {
+        munmap(m_map, m_size);
+        m_map = nullptr;
+    }
+    m_storage.clear();
+    m_data = nullptr;
+    m_size = 0;
+}
+
+PDFBundle PDFBundle::Open(TString const& file_name)
+{
+    int fd = open(file_name.Data(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("PDFBundle: unable to open " + std::string(file_name.Data()));
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(PDFBundleHeader)))
+    {
+        close(fd);
+        throw std::runtime_error("PDFBundle: " + std::string(file_name.Data()) + " is not a PDF bundle");
+    }
+
+    size_t size = st.st_size;
+    void* map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        throw std::runtime_error("PDFBundle: unable to map " + std::string(file_name.Data()));
+    }
+
+    PDFBundle bundle;
+    bundle.m_map = map;
+    bundle.m_data = static_cast<unsigned char const*>(map);
+    bundle.m_size = size;
+    bundle.Validate();
+    return bundle;
+}
+
+PDFBundle PDFBundle::FromHists(std::vector<TH1 const*> const& hists)
+{
+    PDFBundle bundle;
+    bundle.m_storage = SerializePDFs(hists);
+    bundle.m_data = reinterpret_cast<unsigned char const*>(bundle.m_storage.data());
+    bundle.m_size = bundle.m_storage.size()*sizeof(std::uint64_t);
+    bundle.Validate();
+    return bundle;
+}
+
+void PDFBundle::Validate() const
+{
+    auto const* header = reinterpret_cast<PDFBundleHeader const*>(m_data);
+    if (std::memcmp(header->magic, PDF_BUNDLE_MAGIC, sizeof(PDF_BUNDLE_MAGIC)) != 0)
+    {
+        throw std::runtime_error("PDFBundle: wrong magic");
+    }
+    if (header->version != PDF_BUNDLE_VERSION)
+    {
+        throw std::runtime_error("PDFBundle: unsupported version " + std::to_string(header->version));
+    }
+    if (header->total_size != m_size || sizeof(PDFBundleHeader) + header->n_entries*sizeof(PDFBundleEntry) > m_size)
+    {
+        throw std::runtime_error("PDFBundle: truncated bundle");
+    }
+
+    auto const* entries = reinterpret_cast<PDFBundleEntry const*>(m_data + sizeof(PDFBundleHeader));
+    for (std::uint32_t i = 0; i < header->n_entries; ++i)
+    {
+        PDFBundleEntry const& e = entries[i];
+        size_t nbins = static_cast<size_t>(e.nbins_x)*e.nbins_y;
+        bool ok = e.name[PDF_BUNDLE_NAME_SIZE - 1] == '\0'
+               && (e.ndim == 1 || e.ndim == 2)
+               && nbins > 0
+               && e.dens_offset + nbins*sizeof(Float_t) <= m_size
+               && e.cdf_offset + (nbins + 1)*sizeof(double) <= m_size
+               && e.alias_prob_offset + nbins*sizeof(Float_t) <= m_size
+               && e.alias_idx_offset + nbins*sizeof(std::uint32_t) <= m_size
+               && e.cdf_offset % 8 == 0
+               && (e.ndim == 2 || (e.n_inv_cdf > 0 && e.inv_cdf_offset % 8 == 0
+                                   && e.inv_cdf_offset + (e.n_inv_cdf + 1)*sizeof(double) <= m_size))
+               && (e.ndim == 1 || (e.row_alias_prob_offset + nbins*sizeof(Float_t) <= m_size
+                                   && e.row_alias_idx_offset + nbins*sizeof(std::uint32_t) <= m_size));
+        if (!ok)
+        {
+            throw std::runtime_error("PDFBundle: corrupted entry " + std::to_string(i));
+        }
+    }
+}
+
+PDFBundleEntry const* PDFBundle::Find(TString const& name) const
+{
+    auto const* header = reinterpret_cast<PDFBundleHeader const*>(m_data);
+    auto const* entries = reinterpret_cast<PDFBundleEntry const*>(m_data + sizeof(PDFBundleHeader));
+    for (std::uint32_t i = 0; i < header->n_entries; ++i)
+    {
+        if (name == entries[i].name)
+        {
+            return &entries[i];
+        }
+    }
+    throw std::runtime_error("PDFBundle: no PDF " + std::string(name.Data()));
+}
+
+PDF1DView PDFBundle::Get1D(TString const& name) const
+{
+    PDFBundleEntry const* e = Find(name);
+    if (e->ndim != 1)
+    {
+        throw std::runtime_error("PDFBundle: PDF " + std::string(name.Data()) + " is not 1d");
+    }
+
+    PDF1DView view;
+    view.nbins = e->nbins_x;
+    view.xmin = e->xmin;
+    view.xmax = e->xmax;
+    view.dens = reinterpret_cast<Float_t const*>(m_data + e->dens_offset);
+    view.cdf = reinterpret_cast<double const*>(m_data + e->cdf_offset);
+    view.alias_prob = reinterpret_cast<Float_t const*>(m_data + e->alias_prob_offset);
+    view.alias_idx = reinterpret_cast<std::uint32_t const*>(m_data + e->alias_idx_offset);
+    view.n_inv_cdf = e->n_inv_cdf;
+    view.inv_cdf = reinterpret_cast<double const*>(m_data + e->inv_cdf_offset);
+    return view;
+}
+
+PDF2DView PDFBundle::Get2D(TString const& name) const
+{
+    PDFBundleEntry const* e = Find(name);
+    if (e->ndim != 2)
+    {
+        throw std::runtime_error("PDFBundle: PDF " + std::string(name.Data()) + " is not 2d");
+    }
+
+    PDF2DView view;
+    view.nbins_x = e->nbins_x;
+    view.nbins_y = e->nbins_y;
+    view.xmin = e->xmin;
+    view.xmax = e->xmax;
+    view.ymin = e->ymin;
+    view.ymax = e->ymax;
+    view.dens = reinterpret_cast<Float_t const*>(m_data + e->dens_offset);
+    view.cdf = reinterpret_cast<double const*>(m_data + e->cdf_offset);
+    view.alias_prob = reinterpret_cast<Float_t const*>(m_data + e->alias_prob_offset);
+    view.alias_idx = reinterpret_cast<std::uint32_t const*>(m_data + e->alias_idx_offset);
+    view.row_alias_prob = reinterpret_cast<Float_t const*>(m_data + e->row_alias_prob_offset);
+    view.row_alias_idx = reinterpret_cast<std::uint32_t const*>(m_data + e->row_alias_idx_offset);
+    return view;
+}
+
+
+std::vector<std::uint64_t> SerializePDFs(std::vector<TH1 const*> const& hists)
+{
+    // first pass: entries and offsets
+    std::vector<PDFBundleEntry> entries(hists.size());
+    size_t offset = sizeof(PDFBundleHeader) + hists.size()*sizeof(PDFBundleEntry);
+    for (size_t i = 0; i < hists.size(); ++i)
+    {
+        TH1 const* hist = hists[i];
+        TString name = hist->GetName();
+        if (static_cast<size_t>(name.Length()) >= PDF_BUNDLE_NAME_SIZE)
+        {
+            throw std::runtime_error("SerializePDFs: name " + std::string(name.Data()) + " is too long");
+        }
+        if (hist->GetDimension() > 2 || hist->GetXaxis()->IsVariableBinSize() || hist->GetYaxis()->IsVariableBinSize())
+        {
+            throw std::runtime_error("SerializePDFs: " + std::string(name.Data()) + " is not a uniformly binned 1d or 2d histogram");
+        }
+
+        PDFBundleEntry& e = entries[i];
+        std::memset(&e, 0, sizeof(e));
+        std::strncpy(e.name, name.Data(), PDF_BUNDLE_NAME_SIZE - 1);
+        e.ndim = hist->GetDimension();
+        e.nbins_x = hist->GetNbinsX();
+        e.nbins_y = e.ndim == 2 ? hist->GetNbinsY() : 1;
+        e.xmin = hist->GetXaxis()->GetXmin();
+        e.xmax = hist->GetXaxis()->GetXmax();
+        e.ymin = e.ndim == 2 ? hist->GetYaxis()->GetXmin() : 0.0;
+        e.ymax = e.ndim == 2 ? hist->GetYaxis()->GetXmax() : 0.0;
+
+        size_t nbins = static_cast<size_t>(e.nbins_x)*e.nbins_y;
+        e.cdf_offset = offset;
+        offset += (nbins + 1)*sizeof(double);
+        e.dens_offset = offset;
+        offset = Align8(offset + nbins*sizeof(Float_t));
+        e.alias_prob_offset = offset;
+        offset = Align8(offset + nbins*sizeof(Float_t));
+        e.alias_idx_offset = offset;
+        offset = Align8(offset + nbins*sizeof(std::uint32_t));
+        if (e.ndim == 2)
+        {
+            e.row_alias_prob_offset = offset;
+            offset = Align8(offset + nbins*sizeof(Float_t));
+            e.row_alias_idx_offset = offset;
+            offset = Align8(offset + nbins*sizeof(std::uint32_t));
+        }
+        else
+        {
+            e.n_inv_cdf = PDF_INV_CDF_SIZE;
+            e.inv_cdf_offset = offset;
+            offset += (e.n_inv_cdf + 1)*sizeof(double);
+        }
+    }
+
+    std::vector<std::uint64_t> storage(offset/sizeof(std::uint64_t), 0);
+    unsigned char* data = reinterpret_cast<unsigned char*>(storage.data());
+
+    PDFBundleHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, PDF_BUNDLE_MAGIC, sizeof(PDF_BUNDLE_MAGIC));
+    header.version = PDF_BUNDLE_VERSION;
+    header.n_entries = hists.size();
+    header.total_size = offset;
+    std::memcpy(data, &header, sizeof(header));
+    std::memcpy(data + sizeof(header), entries.data(), entries.size()*sizeof(PDFBundleEntry));
+
+    // second pass: arrays
+    for (size_t i = 0; i < hists.size(); ++i)
+    {
+        TH1 const* hist = hists[i];
+        PDFBundleEntry const& e = entries[i];
+        size_t nbins = static_cast<size_t>(e.nbins_x)*e.nbins_y;
+
+        Float_t* dens = reinterpret_cast<Float_t*>(data + e.dens_offset);
+        double* cdf = reinterpret_cast<double*>(data + e.cdf_offset);
+        Float_t* alias_prob = reinterpret_cast<Float_t*>(data + e.alias_prob_offset);
+        std::uint32_t* alias_idx = reinterpret_cast<std::uint32_t*>(data + e.alias_idx_offset);
+
+        // CDF is accumulated and normalized in the same order as TH1::ComputeIntegral
+        cdf[0] = 0.0;
+        size_t ibin = 0;
+        for (std::uint32_t iy = 1; iy <= e.nbins_y; ++iy)
+        {
+            for (std::uint32_t ix = 1; ix <= e.nbins_x; ++ix)
+            {
+                double content = e.ndim == 2 ? hist->GetBinContent(ix, iy) : hist->GetBinContent(ix);
+                if (content < 0.0)
+                {
+                    throw std::runtime_error("SerializePDFs: " + std::string(e.name) + " has negative bins");
+                }
+                dens[ibin] = content;
+                ++ibin;
+                cdf[ibin] = cdf[ibin - 1] + content;
+            }
+        }
+        if (cdf[nbins] > 0.0)
+        {
+            for (size_t bin = 1; bin <= nbins; ++bin)
+            {
+                cdf[bin] /= cdf[nbins];
+            }
+        }
+
+        BuildAliasTable(dens, nbins, alias_prob, alias_idx);
+
+        if (e.ndim == 1)
+        {
+            double* inv_cdf = reinterpret_cast<double*>(data + e.inv_cdf_offset);
+            BuildInverseCDF(cdf, nbins, e.xmin, e.xmax, inv_cdf, e.n_inv_cdf);
+        }
+
+        if (e.ndim == 2)
+        {
+            Float_t* row_alias_prob = reinterpret_cast<Float_t*>(data + e.row_alias_prob_offset);
+            std::uint32_t* row_alias_idx = reinterpret_cast<std::uint32_t*>(data + e.row_alias_idx_offset);
+
+            std::vector<Float_t> marginal(e.nbins_x, 0.0f);
+            for (size_t bin = 0; bin < nbins; ++bin)
+            {
+                marginal[bin % e.nbins_x] += dens[bin];
+            }
+
+            for (std::uint32_t iy = 0; iy < e.nbins_y; ++iy)
+            {
+                size_t offset = static_cast<size_t>(iy)*e.nbins_x;
+                Float_t const* row = dens + offset;
+                bool empty_row = std::all_of(row, row + e.nbins_x, [](Float_t d) { return d == 0.0f; });
+                BuildAliasTable(empty_row ? marginal.data() : row, e.nbins_x, row_alias_prob + offset, row_alias_idx + offset);
+            }
+        }
+    }
+
+    return storage;
+}
+
+void WritePDFBundle(TString const& file_name, std::vector<TH1 const*> const& hists)
+{
+    std::vector<std::uint64_t> storage = SerializePDFs(hists);
+
+    // written to temporary file first: readers never map a partially written bundle
+    TString tmp_name = file_name + ".tmp";
+    {
+        std::ofstream out(tmp_name.Data(), std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<char const*>(storage.data()), storage.size()*sizeof(std::uint64_t));
+        if (!out)
+        {
+            throw std::runtime_error("WritePDFBundle: unable to write " + std::string(tmp_name.Data()));
+        }
+    }
+
+    if (std::rename(tmp_name.Data(), file_name.Data()) != 0)
+    {
+        throw std::runtime_error("WritePDFBundle: unable to rename " + std::string(tmp_name.Data()));
+    }
+}
@@ -0,0 +1,155 @@
+#ifndef PDF_BUNDLE_HPP
+#define PDF_BUNDLE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "TString.h"
+#include "TRandom.h"
+#include "TH1.h"
+
+// flat binary container of uniformly binned 1d and 2d PDFs
+// layout (all offsets are in bytes from the beginning of the file, arrays are 8-byte aligned):
+//   header: magic, version, number of entries, total size
+//   entries: name, binning and offsets of arrays
+//   arrays: densities (float), normalized CDF with nbins + 1 points (double),
+//           alias table probabilities (float) and aliases (uint32),
+//           for 2d PDFs also alias tables of every row (x conditioned on y bin),
+//           for 1d PDFs also smoothed inverse CDF tabulated on a uniform grid (double)
+// file is memory mapped read-only, so startup does not depend on number of bins
+// and pages are shared by all processes mapping the same file
+inline constexpr char PDF_BUNDLE_MAGIC[8] = {'H', 'M', 'E', 'P', 'D', 'F', 'B', '\0'};
+inline constexpr std::uint32_t PDF_BUNDLE_VERSION = 3;
+inline constexpr size_t PDF_BUNDLE_NAME_SIZE = 48;
+// number of intervals of smoothed inverse CDF tables
+inline constexpr std::uint32_t PDF_INV_CDF_SIZE = 4096;
+
+struct PDFBundleHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t n_entries;
+    std::uint64_t total_size;
+};
+
+struct PDFBundleEntry
+{
+    char name[PDF_BUNDLE_NAME_SIZE];
+    std::uint32_t ndim;
+    std::uint32_t nbins_x;
+    std::uint32_t nbins_y;
+    std::uint32_t n_inv_cdf;
+    double xmin;
+    double xmax;
+    double ymin;
+    double ymax;
+    std::uint64_t dens_offset;
+    std::uint64_t cdf_offset;
+    std::uint64_t alias_prob_offset;
+    std::uint64_t alias_idx_offset;
+    // 2d only, zero for 1d PDFs
+    std::uint64_t row_alias_prob_offset;
+    std::uint64_t row_alias_idx_offset;
+    // 1d only, zero for 2d PDFs
+    std::uint64_t inv_cdf_offset;
+};
+
+// read-only view of a 1d PDF stored in a bundle, valid as long as the bundle is alive
+struct PDF1DView
+{
+    std::uint32_t nbins = 0;
+    double xmin = 0.0;
+    double xmax = 0.0;
+    Float_t const* dens = nullptr;
+    double const* cdf = nullptr;
+    Float_t const* alias_prob = nullptr;
+    std::uint32_t const* alias_idx = nullptr;
+    std::uint32_t n_inv_cdf = 0;
+    double const* inv_cdf = nullptr;
+
+    // true for views of PDFs which were not loaded and for PDFs with no entries
+    inline bool IsEmpty() const { return nbins == 0 || cdf[nbins] == 0.0; }
+    // zero outside of [xmin, xmax)
+    Float_t Density(double x) const;
+    // equivalent of TH1::Integral("width")
+    double IntegralWidth() const;
+    // inverse CDF sampling, consumes the same random numbers and returns the same values as TH1::GetRandom
+    double Sample(TRandom* rng) const;
+    // inverse CDF at u in (0, 1], used by Sample and by quasi-random sampling
+    double Quantile(double u) const;
+    // O(1) sampling with the alias table, uniform within the bin
+    double SampleAlias(TRandom* rng) const;
+    // bin-free sampling: inverse of monotone cubic spline through CDF at bin edges,
+    // linearly interpolated between n_inv_cdf + 1 tabulated quantiles
+    double SampleSmooth(TRandom* rng) const;
+    // unit-area density of SampleSmooth
+    Float_t SmoothDensity(double x) const;
+};
+
+// read-only view of a 2d PDF, densities are stored row by row (x is the fastest index)
+struct PDF2DView
+{
+    std::uint32_t nbins_x = 0;
+    std::uint32_t nbins_y = 0;
+    double xmin = 0.0;
+    double xmax = 0.0;
+    double ymin = 0.0;
+    double ymax = 0.0;
+    Float_t const* dens = nullptr;
+    double const* cdf = nullptr;
+    Float_t const* alias_prob = nullptr;
+    std::uint32_t const* alias_idx = nullptr;
+    Float_t const* row_alias_prob = nullptr;
+    std::uint32_t const* row_alias_idx = nullptr;
+
+    inline bool IsEmpty() const { return nbins_x == 0 || cdf[static_cast<size_t>(nbins_x)*nbins_y] == 0.0; }
+    Float_t Density(double x, double y) const;
+    // equivalent of TH2::GetRandom2
+    void Sample(double& x, double& y, TRandom* rng) const;
+    // u1 selects the bin and x within it, u2 gives y within the bin
+    void Quantile(double u1, double u2, double& x, double& y) const;
+    void SampleAlias(double& x, double& y, TRandom* rng) const;
+    // O(1) sampling of x from the row of y, y outside of range is clamped to the first or last row
+    // rows without entries fall back to the marginal distribution of x
+    double SampleX(double y, TRandom* rng) const;
+};
+
+class PDFBundle
+{
+    public:
+    PDFBundle() = default;
+    ~PDFBundle();
+
+    PDFBundle(PDFBundle const&) = delete;
+    PDFBundle& operator=(PDFBundle const&) = delete;
+    PDFBundle(PDFBundle&& other) noexcept;
+    PDFBundle& operator=(PDFBundle&& other) noexcept;
+
+    // maps bundle written by WritePDFBundle
+    static PDFBundle Open(TString const& file_name);
+    // builds bundle in memory, used when PDFs are read from a ROOT file
+    static PDFBundle FromHists(std::vector<TH1 const*> const& hists);
+
+    PDF1DView Get1D(TString const& name) const;
+    PDF2DView Get2D(TString const& name) const;
+
+    inline size_t Size() const { return m_size; }
+
+    private:
+    PDFBundleEntry const* Find(TString const& name) const;
+    void Validate() const;
+    void Release();
+
+    // bundle is either owned in memory or mapped from file
+    std::vector<std::uint64_t> m_storage;
+    void* m_map = nullptr;
+    unsigned char const* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+// serializes histograms to bundle format, histograms must be uniformly binned TH1 or TH2
+std::vector<std::uint64_t> SerializePDFs(std::vector<TH1 const*> const& hists);
+void WritePDFBundle(TString const& file_name, std::vector<TH1 const*> const& hists);
+
+#endif
@@ -0,0 +1,29 @@
+#include "PDFTable.hpp"
+
+#include <algorithm>
+
+PDFTable1D::PDFTable1D(PDF1DView const& pdf)
+{
+    m_dens.assign(pdf.nbins + 2, 0.0f);
+    std::copy(pdf.dens, pdf.dens + pdf.nbins, m_dens.begin() + 1);
+
+    m_xmin = pdf.xmin;
+    m_inv_width = pdf.nbins/(pdf.xmax - pdf.xmin);
+    m_nbins = pdf.nbins;
+}
+
+void PDFTable1D::Density(Float_t const* x, Float_t* out, size_t n) const
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        out[i] = m_dens[Index(x[i])];
+    }
+}
+
+void PDFTable1D::MultiplyDensity(Float_t const* x, Float_t* w, size_t n) const
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        w[i] *= m_dens[Index(x[i])];
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef PDF_TABLE_HPP
+#define PDF_TABLE_HPP
+
+#include <vector>
+
+#include "PDFBundle.hpp"
+
+// flat copy of a uniformly binned PDF for fast density lookup
+// under- and overflow are mapped to zero density
+class PDFTable1D
+{
+    public:
+    PDFTable1D() = default;
+    explicit PDFTable1D(PDF1DView const& pdf);
+
+    inline Float_t Density(Float_t x) const
+    {
+        return m_dens[Index(x)];
+    }
+
+    // out[i] = p(x[i])
+    void Density(Float_t const* x, Float_t* out, size_t n) const;
+    // w[i] *= p(x[i])
+    void MultiplyDensity(Float_t const* x, Float_t* w, size_t n) const;
+
+    private:
+    inline size_t Index(Float_t x) const
+    {
+        // NaN is mapped to underflow
+        Float_t pos = (x - m_xmin)*m_inv_width;
+        pos = pos > -1.0f ? pos : -1.0f;
+        pos = pos < m_nbins ? pos : m_nbins;
+        return static_cast<size_t>(pos + 1.0f);
+    }
+
+    std::vector<Float_t> m_dens = {0.0f, 0.0f};
+    Float_t m_xmin = 0.0f;
+    Float_t m_inv_width = 0.0f;
+    Float_t m_nbins = 0.0f;
+};
+
+
+#endif
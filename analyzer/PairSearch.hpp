@@ -0,0 +1,176 @@
+#ifndef PAIR_SEARCH_HPP
+#define PAIR_SEARCH_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+// sum of objects i and j, built from cached cartesian components
+struct Dijet
+{
+    int i = -1;
+    int j = -1;
+    double px = 0.0;
+    double py = 0.0;
+    double pz = 0.0;
+    double e = 0.0;
+
+    // same conventions as TLorentzVector: negative mass for spacelike sums, eta = +-1e10 along the beam axis
+    inline double M() const
+    {
+        double m2 = e*e - px*px - py*py - pz*pz;
+        return m2 < 0.0 ? -std::sqrt(-m2) : std::sqrt(m2);
+    }
+    inline double Pt() const { return std::hypot(px, py); }
+    inline double Phi() const { return px == 0.0 && py == 0.0 ? 0.0 : std::atan2(py, px); }
+    inline double Eta() const
+    {
+        double pt = Pt();
+        if (pt > 0.0)
+        {
+            return std::asinh(pz/pt);
+        }
+        return pz == 0.0 ? 0.0 : (pz > 0.0 ? 1e10 : -1e10);
+    }
+};
+
+struct PairCandidate
+{
+    int i = -1;
+    int j = -1;
+    double metric = 0.0;
+};
+
+// accepts dijets within max_dr of direction (eta, phi)
+// |deta| is checked first, so most pairs outside of the cone are rejected without atan2
+class DijetCone
+{
+    public:
+    DijetCone(double eta, double phi, double max_dr)
+    :   m_eta(eta)
+    ,   m_phi(phi)
+    ,   m_max_dr2(max_dr*max_dr)
+    {}
+
+    bool operator()(Dijet const& dijet) const
+    {
+        double deta = dijet.Eta() - m_eta;
+        if (deta*deta >= m_max_dr2)
+        {
+            return false;
+        }
+        double dphi = std::abs(dijet.Phi() - m_phi);
+        dphi = std::min(dphi, 2.0*PI - dphi);
+        return deta*deta + dphi*dphi < m_max_dr2;
+    }
+
+    private:
+    static constexpr double PI = 3.14159265358979323846;
+
+    double m_eta;
+    double m_phi;
+    double m_max_dr2;
+};
+
+// search for k pairs i < j of objects (jets) with the smallest metric
+// 4-momenta are cached as px, py, pz, E once per event, so a pair costs four additions plus accept and metric
+// pairs rejected by accept are skipped before metric is evaluated
+// best candidates are kept in a sorted buffer of size k instead of sorting all pairs, ties keep the earlier pair
+class PairSearch
+{
+    public:
+    // Vec is any 4-vector with Px(), Py(), Pz() and E()
+    template <typename Vec>
+    void SetObjects(std::vector<Vec> const& objects)
+    {
+        size_t n = objects.size();
+        m_px.resize(n);
+        m_py.resize(n);
+        m_pz.resize(n);
+        m_e.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            m_px[i] = objects[i].Px();
+            m_py[i] = objects[i].Py();
+            m_pz[i] = objects[i].Pz();
+            m_e[i] = objects[i].E();
+        }
+    }
+
+    inline int Size() const { return m_px.size(); }
+    inline Dijet Sum(int i, int j) const { return {i, j, m_px[i] + m_px[j], m_py[i] + m_py[j], m_pz[i] + m_pz[j], m_e[i] + m_e[j]}; }
+    inline double Dot3(int i, int j) const { return m_px[i]*m_px[j] + m_py[i]*m_py[j] + m_pz[i]*m_pz[j]; }
+
+    // opening angle of 3-momenta of objects i and j, same conventions as TVector3::Angle
+    inline double Angle(int i, int j) const
+    {
+        double ptot2 = Dot3(i, i)*Dot3(j, j);
+        if (ptot2 <= 0.0)
+        {
+            return 0.0;
+        }
+        return std::acos(std::clamp(Dot3(i, j)/std::sqrt(ptot2), -1.0, 1.0));
+    }
+
+    // metric(Dijet const&) -> double, smaller is better; accept(Dijet const&) -> bool
+    // returned candidates are sorted by metric and valid until the next search
+    template <typename Metric, typename Accept>
+    std::vector<PairCandidate> const& TopK(int k, Metric metric, Accept accept)
+    {
+        m_best.clear();
+        int n = Size();
+        for (int i = 0; i < n && k > 0; ++i)
+        {
+            for (int j = i + 1; j < n; ++j)
+            {
+                Dijet dijet = Sum(i, j);
+                if (!accept(dijet))
+                {
+                    continue;
+                }
+
+                double value = metric(dijet);
+                bool full = static_cast<int>(m_best.size()) == k;
+                if (full && !(value < m_best.back().metric))
+                {
+                    continue;
+                }
+
+                auto Cmp = [](double v, PairCandidate const& c) { return v < c.metric; };
+                size_t pos = std::upper_bound(m_best.begin(), m_best.end(), value, Cmp) - m_best.begin();
+                if (full)
+                {
+                    m_best.pop_back();
+                }
+                m_best.insert(m_best.begin() + pos, PairCandidate{i, j, value});
+            }
+        }
+        return m_best;
+    }
+
+    template <typename Metric>
+    std::vector<PairCandidate> const& TopK(int k, Metric metric)
+    {
+        return TopK(k, metric, [](Dijet const&) { return true; });
+    }
+
+    private:
+    std::vector<double> m_px;
+    std::vector<double> m_py;
+    std::vector<double> m_pz;
+    std::vector<double> m_e;
+    std::vector<PairCandidate> m_best;
+};
+
+// pair i < j with the smallest metric(Dijet const&), {-1, -1} if there are less than two jets
+template <typename Vec, typename Metric>
+std::pair<int, int> ChooseBestPair(std::vector<Vec> const& jets, Metric metric)
+{
+    PairSearch search;
+    search.SetObjects(jets);
+    auto const& best = search.TopK(1, metric);
+    return best.empty() ? std::pair<int, int>{-1, -1} : std::pair<int, int>{best[0].i, best[0].j};
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include "SelectionUtils.hpp"
 #include "MatchingTools.hpp"
+#include "JetAssignment.hpp"
+
+#include <stdexcept>
 
 #include "Math/GenVector/VectorUtil.h" 
 using ROOT::Math::VectorUtil::DeltaR;
@@ -78,6 +81,22 @@ bool IsRecoverable(Storage const& s, Channel ch, bool top_sel)
     return true;
 }
 
+namespace
+{
+    bool CorrRecoLeptons(Storage const& s, Channel ch)
+    {
+        int n_lep = ch == Channel::DL ? 2 : 1;
+        for (int i = 0; i < n_lep; ++i)
+        {
+            if (!CorrRecoLep(s.reco_lep_type[i], s.reco_lep_gen_kind[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
 bool IsFiducial(Storage const& s, VecLVF_t const& jets, Channel ch)
 {
     // check quark to reco jet matching
@@ -88,27 +107,26 @@ bool IsFiducial(Storage const& s, VecLVF_t const& jets, Channel ch)
         quarks_p4.push_back(LorentzVectorF_t(s.gen_quark_pt[i], s.gen_quark_eta[i], s.gen_quark_phi[i], s.gen_quark_mass[i]));
     }
 
-    std::unordered_set<int> matches;
-    for (auto const& qp4: quarks_p4)
+    if (!MatchPartons(quarks_p4, jets).IsComplete())
     {
-        int idx = MatchIdx(qp4, jets);
-        matches.insert(idx);
+        return false;
     }
 
-    if (matches.count(-1) || matches.size() != quarks_p4.size())
+    // check lepton reconstruction
+    return CorrRecoLeptons(s, ch);
+}
+
+bool IsFiducial(Storage const& s, MatchRecord const& match, Channel ch)
+{
+    if (match.event != s.eventId)
     {
-        return false;
+        throw std::runtime_error("Matching friend tree is not aligned with input tree, rerun match_tree");
     }
 
-    // check lepton reconstruction
-    int n_lep = ch == Channel::DL ? 2 : 1;
-    for (int i = 0; i < n_lep; ++i)
+    if (!match.IsComplete())
     {
-        if (!CorrRecoLep(s.reco_lep_type[i], s.reco_lep_gen_kind[i]))
-        {
-            return false;
-        }
+        return false;
     }
 
-    return true;
+    return CorrRecoLeptons(s, ch);
 }
\ No newline at end of file
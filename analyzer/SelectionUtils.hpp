@@ -2,10 +2,13 @@
 #define SELEC_UTILS_HPP
 
 #include "Storage.hpp"
+#include "MatchTree.hpp"
 
 // true if event is passing a selection, false otherwise
 bool IsRecoverable(Storage const& s, Channel ch, bool top_sel = true);
 bool IsFiducial(Storage const& s, VecLVF_t const& jets, Channel ch);
+// same selection with matching read from friend tree
+bool IsFiducial(Storage const& s, MatchRecord const& match, Channel ch);
 
 bool CorrRecoLep(int lep_type, int lep_genLep_kind);
 
@@ -8,22 +8,47 @@
 #include "Analyzer.hpp"
 #include "Constants.hpp"
 
-int main()
+int main(int argc, char* argv[])
 {
     gROOT->ProcessLine("gErrorIgnoreLevel = 6001;");
 
     TString tree_name = "Events";
-    TString pdf_file_name = "pdf_sl.root";
-    // TString pdf_file_name = "pdf_dl.root";
+    TString pdf_file_name_sl = "pdf_sl.root";
+    TString pdf_file_name_dl = "pdf_dl.root";
 
     std::map<TString, Channel> input_file_map = { { "nano_sl_M800.root", Channel::SL },
                                                   { "nano_dl_M800.root", Channel::DL } };
 
     Mode mode = Mode::Validation;
-
-    Analyzer ana(tree_name, input_file_map, pdf_file_name, mode);
+    // ./analysis [eqns|weights] [uniform|importance] [histograms.root]
+    // sampling of neutrino direction in DL channel; efficiency printed per file compares the two samplings
+    // importance sampling is opt-in until its acceptance gain and mass distribution are validated against uniform
+    // output name allows to keep histograms of several runs, e.g. with and without FAST_MATH
+    Method method = Method::Eqns;
+    if (argc > 1 && TString(argv[1]) == "weights")
+    {
+        method = Method::Weights;
+    }
+
+    Sampling sampling = Sampling::Uniform;
+    if (argc > 2 && TString(argv[2]) == "importance")
+    {
+        sampling = Sampling::Importance;
+    }
+
+    TString hist_file_name = argc > 3 ? argv[3] : "histograms.root";
+
+    Analyzer ana(tree_name, input_file_map, pdf_file_name_sl, pdf_file_name_dl, mode, method, sampling);
     ana.ProcessFile("nano_sl_M800.root", Channel::SL);
-    // ana.ProcessFile("nano_dl_M800.root", Channel::DL);
+    if (ana.HasChannel(Channel::DL))
+    {
+        ana.ProcessFile("nano_dl_M800.root", Channel::DL);
+    }
+    else
+    {
+        std::cout << "weights method is not implemented in DL channel, nano_dl_M800.root is skipped\n";
+    }
+    ana.WriteHistograms(hist_file_name);
 
     return 0;
 }
\ No newline at end of file
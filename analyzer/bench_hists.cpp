@@ -0,0 +1,234 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "TROOT.h"
+#include "TH1.h"
+#include "TRandom3.h"
+#include "TString.h"
+
+#include "HistManager.hpp"
+#include "ConcurrentHist.hpp"
+
+// scaling of concurrent histogram filling with number of threads
+// n_events synthetic events fill N_HISTS 1d histograms each, values are generated up front so only filling is timed;
+// events are split into contiguous ranges, one per thread:
+//   serial - one HistManager on the main thread, reference for speedup and contents,
+//   sharded - every thread fills its own HistShards shard, shards are merged after join (merge is included in time),
+//   atomic - all threads fill shared AtomicHist1D
+// for every strategy and number of threads from 1 to max_threads: fills/s, speedup over serial, merge time
+// and largest difference of bin contents from serial (must be 0, weights are 1)
+// usage: bench_hists [n_events] [max_threads] [output.json]
+
+inline constexpr long DEFAULT_N_EVENTS = 2000000;
+inline constexpr int N_HISTS = 8;
+inline constexpr int N_BINS = 100;
+inline constexpr double XMIN = 0.0;
+inline constexpr double XMAX = 2000.0;
+
+struct BenchResult
+{
+    TString strategy;
+    int n_threads = 1;
+    double fills_per_s = 0.0;
+    double speedup = 1.0;
+    double merge_s = 0.0;
+    double max_diff = 0.0;
+};
+
+// values[e*N_HISTS + k] is value of histogram k in event e
+std::vector<double> MakeValues(long n_events)
+{
+    TRandom3 rng(42);
+    std::vector<double> values(n_events*N_HISTS);
+    for (long e = 0; e < n_events; ++e)
+    {
+        for (int k = 0; k < N_HISTS; ++k)
+        {
+            // mass-like peaks of different widths, tails fill overflow
+            values[e*N_HISTS + k] = rng.Gaus(250.0*(k + 1), 20.0*(k + 1));
+        }
+    }
+    return values;
+}
+
+// process(t, begin, end) is called on thread t for events [begin, end)
+template <typename Process>
+void RunThreads(long n_events, int n_threads, Process process)
+{
+    std::vector<std::thread> threads;
+    for (int t = 0; t < n_threads; ++t)
+    {
+        long begin = n_events*t/n_threads;
+        long end = n_events*(t + 1)/n_threads;
+        threads.emplace_back(process, t, begin, end);
+    }
+
+    for (auto& t: threads)
+    {
+        t.join();
+    }
+}
+
+double MaxDiff(TH1 const* h, TH1 const* ref)
+{
+    double max_diff = 0.0;
+    for (int i = 0; i <= ref->GetNbinsX() + 1; ++i)
+    {
+        max_diff = std::max(max_diff, std::abs(h->GetBinContent(i) - ref->GetBinContent(i)));
+    }
+    return max_diff;
+}
+
+HistManager MakeManager(std::vector<Hist1DHandle>& handles)
+{
+    HistManager hm;
+    handles.clear();
+    for (int k = 0; k < N_HISTS; ++k)
+    {
+        handles.push_back(hm.Add(Form("h%d", k), Form("h%d", k), {"x", "N"}, {XMIN, XMAX}, N_BINS));
+    }
+    return hm;
+}
+
+BenchResult RunSharded(std::vector<double> const& values, int n_threads, HistManager const& ref, std::vector<Hist1DHandle> const& ref_handles)
+{
+    long n_events = values.size()/N_HISTS;
+    std::vector<Hist1DHandle> handles;
+    HistManager hm = MakeManager(handles);
+    HistShards shards(hm, n_threads);
+
+    auto start = std::chrono::steady_clock::now();
+    RunThreads(n_events, n_threads, [&](int t, long begin, long end)
+    {
+        HistManager& shard = shards.Shard(t);
+        for (long e = begin; e < end; ++e)
+        {
+            for (int k = 0; k < N_HISTS; ++k)
+            {
+                shard.Fill(handles[k], values[e*N_HISTS + k]);
+            }
+        }
+    });
+    auto merge_start = std::chrono::steady_clock::now();
+    shards.MergeInto(hm);
+    auto finish = std::chrono::steady_clock::now();
+
+    BenchResult res;
+    res.strategy = "sharded";
+    res.n_threads = n_threads;
+    res.fills_per_s = values.size()/std::chrono::duration<double>(finish - start).count();
+    res.merge_s = std::chrono::duration<double>(finish - merge_start).count();
+    for (int k = 0; k < N_HISTS; ++k)
+    {
+        res.max_diff = std::max(res.max_diff, MaxDiff(hm.Get(handles[k]), ref.Get(ref_handles[k])));
+    }
+    return res;
+}
+
+BenchResult RunAtomic(std::vector<double> const& values, int n_threads, HistManager const& ref, std::vector<Hist1DHandle> const& ref_handles)
+{
+    long n_events = values.size()/N_HISTS;
+    std::vector<std::unique_ptr<AtomicHist1D>> hists;
+    for (int k = 0; k < N_HISTS; ++k)
+    {
+        hists.push_back(std::make_unique<AtomicHist1D>(N_BINS, XMIN, XMAX));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    RunThreads(n_events, n_threads, [&](int, long begin, long end)
+    {
+        for (long e = begin; e < end; ++e)
+        {
+            for (int k = 0; k < N_HISTS; ++k)
+            {
+                hists[k]->Fill(values[e*N_HISTS + k]);
+            }
+        }
+    });
+    auto finish = std::chrono::steady_clock::now();
+
+    BenchResult res;
+    res.strategy = "atomic";
+    res.n_threads = n_threads;
+    res.fills_per_s = values.size()/std::chrono::duration<double>(finish - start).count();
+    for (int k = 0; k < N_HISTS; ++k)
+    {
+        TH1F h(Form("atomic_h%d", k), "", N_BINS, XMIN, XMAX);
+        hists[k]->AddTo(&h);
+        res.max_diff = std::max(res.max_diff, MaxDiff(&h, ref.Get(ref_handles[k])));
+    }
+    return res;
+}
+
+void WriteJSON(TString const& file_name, long n_events, std::vector<BenchResult> const& results)
+{
+    std::ofstream out(file_name.Data());
+    out << "{\n  \"n_events\": " << n_events << ",\n  \"n_hists\": " << N_HISTS << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        BenchResult const& r = results[i];
+        out << "    {\"strategy\": \"" << r.strategy << "\", \"n_threads\": " << r.n_threads << ", "
+            << "\"fills_per_s\": " << r.fills_per_s << ", \"speedup\": " << r.speedup << ", "
+            << "\"merge_s\": " << r.merge_s << ", \"max_diff\": " << r.max_diff << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    if (!out)
+    {
+        throw std::runtime_error("Unable to write " + std::string(file_name.Data()));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    ROOT::EnableThreadSafety();
+    TH1::AddDirectory(false);
+
+    long n_events = argc > 1 ? TString(argv[1]).Atoll() : DEFAULT_N_EVENTS;
+    int max_threads = argc > 2 ? TString(argv[2]).Atoi() : std::max(1u, std::thread::hardware_concurrency());
+    TString json_name = argc > 3 ? argv[3] : "bench_hists.json";
+
+    std::vector<double> values = MakeValues(n_events);
+
+    std::vector<Hist1DHandle> ref_handles;
+    HistManager ref = MakeManager(ref_handles);
+    auto start = std::chrono::steady_clock::now();
+    for (long e = 0; e < n_events; ++e)
+    {
+        for (int k = 0; k < N_HISTS; ++k)
+        {
+            ref.Fill(ref_handles[k], values[e*N_HISTS + k]);
+        }
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    std::vector<BenchResult> results;
+    BenchResult serial;
+    serial.strategy = "serial";
+    serial.fills_per_s = values.size()/std::chrono::duration<double>(finish - start).count();
+    results.push_back(serial);
+
+    for (int n_threads = 1; n_threads <= max_threads; ++n_threads)
+    {
+        results.push_back(RunSharded(values, n_threads, ref, ref_handles));
+        results.push_back(RunAtomic(values, n_threads, ref, ref_handles));
+    }
+
+    for (auto& r: results)
+    {
+        r.speedup = r.fills_per_s/serial.fills_per_s;
+        std::cout << r.strategy << " " << r.n_threads << " threads: " << r.fills_per_s << " fills/s, speedup " << r.speedup
+                  << ", merge " << r.merge_s << " s, max diff " << r.max_diff << "\n";
+    }
+
+    WriteJSON(json_name, n_events, results);
+    std::cout << "Results written to " << json_name << "\n";
+    return 0;
+}
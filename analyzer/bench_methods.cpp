@@ -0,0 +1,86 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <stdexcept>
+
+#include "TString.h"
+#include "TROOT.h"
+
+#include "Analyzer.hpp"
+#include "Constants.hpp"
+
+// throughput and resolution of eqns and weights estimation methods on the same SL input
+// (weights method exists only in SL channel)
+// every method processes the whole file with a fresh Analyzer, so both start from the same random seed
+// per method: events/s, speedup over eqns, fraction of selected events with an estimate,
+// median and 68% width of estimated masses, bias of median w.r.t. true_mass and sampling efficiency
+// usage: bench_methods [input_sl.root] [true_mass] [output.json] [pdf_sl.root] [pdf_dl.root]
+
+struct MethodResult
+{
+    TString method;
+    FileSummary summary;
+    double events_per_s = 0.0;
+};
+
+void WriteJSON(TString const& file_name, TString const& input, double true_mass, std::vector<MethodResult> const& results)
+{
+    std::ofstream out(file_name.Data());
+    out << "{\n  \"input\": \"" << input << "\",\n  \"true_mass\": " << true_mass << ",\n  \"results\": [\n";
+    double eqns_rate = results.front().events_per_s;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        MethodResult const& r = results[i];
+        FileSummary const& s = r.summary;
+        out << "    {\"method\": \"" << r.method << "\", \"n_events\": " << s.n_events << ", \"n_estimated\": " << s.n_estimated << ", "
+            << "\"seconds\": " << s.seconds << ", \"events_per_s\": " << r.events_per_s << ", "
+            << "\"speedup\": " << (eqns_rate > 0.0 ? r.events_per_s/eqns_rate : 0.0) << ", "
+            << "\"median\": " << s.median << ", \"bias\": " << (true_mass > 0.0 ? s.median/true_mass - 1.0 : 0.0) << ", "
+            << "\"width\": " << s.width << ", \"rel_width\": " << (s.median > 0.0 ? s.width/s.median : 0.0) << ", "
+            << "\"efficiency\": " << s.efficiency << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    if (!out)
+    {
+        throw std::runtime_error("Unable to write " + std::string(file_name.Data()));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    gROOT->ProcessLine("gErrorIgnoreLevel = 6001;");
+
+    TString input = argc > 1 ? argv[1] : "nano_sl_M800.root";
+    double true_mass = argc > 2 ? TString(argv[2]).Atof() : 800.0;
+    TString json_name = argc > 3 ? argv[3] : "bench_methods.json";
+    TString pdf_file_name_sl = argc > 4 ? argv[4] : "pdf_sl.root";
+    TString pdf_file_name_dl = argc > 5 ? argv[5] : "pdf_dl.root";
+
+    std::map<TString, Channel> input_file_map = { { input, Channel::SL } };
+
+    std::vector<MethodResult> results;
+    for (Method method: {Method::Eqns, Method::Weights})
+    {
+        MethodResult res;
+        res.method = method == Method::Eqns ? "eqns" : "weights";
+        std::cout << "=== " << res.method << " ===\n";
+
+        Analyzer ana("Events", input_file_map, pdf_file_name_sl, pdf_file_name_dl, Mode::Validation, method);
+        res.summary = ana.ProcessFile(input, Channel::SL);
+        res.events_per_s = res.summary.seconds > 0.0 ? res.summary.n_events/res.summary.seconds : 0.0;
+        results.push_back(res);
+    }
+
+    for (auto const& r: results)
+    {
+        FileSummary const& s = r.summary;
+        std::cout << r.method << ": " << r.events_per_s << " events/s, " << s.n_estimated << "/" << s.n_events << " estimated, "
+                  << "median=" << s.median << ", width=" << s.width << ", rel_width=" << (s.median > 0.0 ? s.width/s.median : 0.0) << "\n";
+    }
+
+    WriteJSON(json_name, input, true_mass, results);
+    std::cout << "Results written to " << json_name << "\n";
+    return 0;
+}
@@ -0,0 +1,298 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#include "TFile.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TRandom3.h"
+#include "TString.h"
+
+#include "Constants.hpp"
+#include "PDFBundle.hpp"
+
+// throughput and fidelity of PDF sampling backends
+// every PDF of pdf_sl.root/pdf_dl.root is sampled n_samples times by each backend on a single core:
+//   root - TH1::GetRandom/TH2::GetRandom2, inv_cdf - PDF1DView/PDF2DView::Sample,
+//   alias - alias table, smooth - spline-smoothed inverse CDF (1d only),
+//   qmc - inverse CDF driven by randomly shifted additive recurrence (golden ratio in 1d, R2 sequence in 2d)
+// fidelity is measured in binning of the source histogram: chi2/ndf over non-empty bins and
+// Kolmogorov distance of cumulative counts (in flattened bin order for 2d), samples in empty bins are counted separately
+// usage: bench_pdfs [n_samples] [output.json] [pdf_sl.root] [pdf_dl.root]
+
+inline constexpr long DEFAULT_N_SAMPLES = 1000000;
+
+struct BenchResult
+{
+    TString channel;
+    TString pdf;
+    TString backend;
+    long n_samples = 0;
+    double samples_per_s = 0.0;
+    double chi2_ndf = 0.0;
+    double ks_d = 0.0;
+    long n_empty_bin = 0;
+};
+
+// randomly shifted additive recurrence, u_n = frac(shift + n*alpha)
+class QMCSequence
+{
+    public:
+    QMCSequence(double alpha, TRandom* rng)
+    :   m_alpha(alpha)
+    ,   m_u(rng->Rndm())
+    {}
+
+    inline double Next()
+    {
+        m_u += m_alpha;
+        m_u -= std::floor(m_u);
+        // 0 is not a valid argument of inverse CDF
+        return m_u > 0.0 ? m_u : std::numeric_limits<double>::min();
+    }
+
+    private:
+    double m_alpha;
+    double m_u;
+};
+
+inline constexpr double GOLDEN_ALPHA = 0.6180339887498949;
+// R2 sequence: 1/g and 1/g^2, g is plastic number
+inline constexpr double R2_ALPHA1 = 0.7548776662466927;
+inline constexpr double R2_ALPHA2 = 0.5698402909980532;
+
+// samples x are histogrammed with flattened bin index idx(x) into source binning with probabilities prob
+BenchResult Evaluate(std::vector<size_t> const& idx, std::vector<double> const& prob, double seconds)
+{
+    BenchResult res;
+    long n = idx.size();
+    res.n_samples = n;
+    res.samples_per_s = seconds > 0.0 ? n/seconds : 0.0;
+
+    std::vector<long> counts(prob.size(), 0);
+    for (auto i: idx)
+    {
+        if (i < counts.size())
+        {
+            ++counts[i];
+        }
+    }
+
+    double chi2 = 0.0;
+    int ndf = -1;
+    double cum_obs = 0.0;
+    double cum_exp = 0.0;
+    for (size_t i = 0; i < prob.size(); ++i)
+    {
+        if (prob[i] > 0.0)
+        {
+            double expected = n*prob[i];
+            chi2 += (counts[i] - expected)*(counts[i] - expected)/expected;
+            ++ndf;
+        }
+        else
+        {
+            res.n_empty_bin += counts[i];
+        }
+        cum_obs += counts[i];
+        cum_exp += prob[i];
+        res.ks_d = std::max(res.ks_d, std::abs(cum_obs/n - cum_exp));
+    }
+    res.chi2_ndf = ndf > 0 ? chi2/ndf : 0.0;
+    return res;
+}
+
+std::vector<double> Probabilities(Float_t const* dens, size_t nbins)
+{
+    double total = 0.0;
+    for (size_t i = 0; i < nbins; ++i)
+    {
+        total += dens[i];
+    }
+
+    std::vector<double> prob(nbins, 0.0);
+    for (size_t i = 0; i < nbins; ++i)
+    {
+        prob[i] = dens[i]/total;
+    }
+    return prob;
+}
+
+template <typename Draw>
+BenchResult Run1D(PDF1DView const& pdf, long n, Draw draw)
+{
+    std::vector<double> xs(n);
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; ++i)
+    {
+        xs[i] = draw();
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    double width = (pdf.xmax - pdf.xmin)/pdf.nbins;
+    std::vector<size_t> idx(n);
+    for (long i = 0; i < n; ++i)
+    {
+        double pos = (xs[i] - pdf.xmin)/width;
+        idx[i] = pos >= 0.0 && pos < pdf.nbins ? static_cast<size_t>(pos) : std::numeric_limits<size_t>::max();
+    }
+    return Evaluate(idx, Probabilities(pdf.dens, pdf.nbins), std::chrono::duration<double>(finish - start).count());
+}
+
+template <typename Draw>
+BenchResult Run2D(PDF2DView const& pdf, long n, Draw draw)
+{
+    std::vector<double> xs(n);
+    std::vector<double> ys(n);
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; ++i)
+    {
+        draw(xs[i], ys[i]);
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    double xwidth = (pdf.xmax - pdf.xmin)/pdf.nbins_x;
+    double ywidth = (pdf.ymax - pdf.ymin)/pdf.nbins_y;
+    std::vector<size_t> idx(n);
+    for (long i = 0; i < n; ++i)
+    {
+        double xpos = (xs[i] - pdf.xmin)/xwidth;
+        double ypos = (ys[i] - pdf.ymin)/ywidth;
+        bool inside = xpos >= 0.0 && xpos < pdf.nbins_x && ypos >= 0.0 && ypos < pdf.nbins_y;
+        idx[i] = inside ? static_cast<size_t>(ypos)*pdf.nbins_x + static_cast<size_t>(xpos) : std::numeric_limits<size_t>::max();
+    }
+    size_t nbins = static_cast<size_t>(pdf.nbins_x)*pdf.nbins_y;
+    return Evaluate(idx, Probabilities(pdf.dens, nbins), std::chrono::duration<double>(finish - start).count());
+}
+
+template <typename T>
+std::unique_ptr<TH1> ReadPDF(TFile* file, TString const& name)
+{
+    std::unique_ptr<TH1> pdf(file->Get<T>(name));
+    if (!pdf)
+    {
+        throw std::runtime_error("PDF " + std::string(name.Data()) + " is missing");
+    }
+    pdf->SetDirectory(nullptr);
+    return pdf;
+}
+
+template <typename PDF1, typename PDF2>
+void BenchChannel(TString const& channel,
+                  TString const& file_name,
+                  std::unordered_map<PDF1, TString> const& names_1d,
+                  std::unordered_map<PDF2, TString> const& names_2d,
+                  long n,
+                  std::vector<BenchResult>& results)
+{
+    std::unique_ptr<TFile> file(TFile::Open(file_name));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to open " + std::string(file_name.Data()));
+    }
+
+    std::vector<std::unique_ptr<TH1>> hists_1d;
+    std::vector<std::unique_ptr<TH1>> hists_2d;
+    std::vector<TH1 const*> hist_ptrs;
+    for (auto const& [pdf, name]: names_1d)
+    {
+        hists_1d.push_back(ReadPDF<TH1F>(file.get(), name));
+        hist_ptrs.push_back(hists_1d.back().get());
+    }
+    for (auto const& [pdf, name]: names_2d)
+    {
+        hists_2d.push_back(ReadPDF<TH2F>(file.get(), name));
+        hist_ptrs.push_back(hists_2d.back().get());
+    }
+    PDFBundle bundle = PDFBundle::FromHists(hist_ptrs);
+
+    TRandom3 rng(SEED);
+    auto add = [&](BenchResult res, TString const& pdf, TString const& backend)
+    {
+        res.channel = channel;
+        res.pdf = pdf;
+        res.backend = backend;
+        std::cout << channel << " " << pdf << " " << backend << ": " << res.samples_per_s << " samples/s, chi2/ndf=" << res.chi2_ndf
+                  << ", ks_d=" << res.ks_d << ", in empty bins " << res.n_empty_bin << "\n";
+        results.push_back(res);
+    };
+
+    for (auto const& hist: hists_1d)
+    {
+        TString name = hist->GetName();
+        PDF1DView pdf = bundle.Get1D(name);
+        if (pdf.IsEmpty())
+        {
+            continue;
+        }
+
+        TH1 const* h = hist.get();
+        add(Run1D(pdf, n, [&]() { return h->GetRandom(&rng); }), name, "root");
+        add(Run1D(pdf, n, [&]() { return pdf.Sample(&rng); }), name, "inv_cdf");
+        add(Run1D(pdf, n, [&]() { return pdf.SampleAlias(&rng); }), name, "alias");
+        add(Run1D(pdf, n, [&]() { return pdf.SampleSmooth(&rng); }), name, "smooth");
+        QMCSequence qmc(GOLDEN_ALPHA, &rng);
+        add(Run1D(pdf, n, [&]() { return pdf.Quantile(qmc.Next()); }), name, "qmc");
+    }
+
+    for (auto const& hist: hists_2d)
+    {
+        TString name = hist->GetName();
+        PDF2DView pdf = bundle.Get2D(name);
+        if (pdf.IsEmpty())
+        {
+            continue;
+        }
+
+        TH2* h = static_cast<TH2*>(hist.get());
+        add(Run2D(pdf, n, [&](double& x, double& y) { h->GetRandom2(x, y, &rng); }), name, "root");
+        add(Run2D(pdf, n, [&](double& x, double& y) { pdf.Sample(x, y, &rng); }), name, "inv_cdf");
+        add(Run2D(pdf, n, [&](double& x, double& y) { pdf.SampleAlias(x, y, &rng); }), name, "alias");
+        QMCSequence qmc1(R2_ALPHA1, &rng);
+        QMCSequence qmc2(R2_ALPHA2, &rng);
+        add(Run2D(pdf, n, [&](double& x, double& y) { pdf.Quantile(qmc1.Next(), qmc2.Next(), x, y); }), name, "qmc");
+    }
+}
+
+void WriteJSON(TString const& file_name, long n, std::vector<BenchResult> const& results)
+{
+    std::ofstream out(file_name.Data());
+    out << "{\n  \"n_samples\": " << n << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        BenchResult const& r = results[i];
+        out << "    {\"channel\": \"" << r.channel << "\", \"pdf\": \"" << r.pdf << "\", \"backend\": \"" << r.backend << "\", "
+            << "\"samples_per_s\": " << r.samples_per_s << ", \"chi2_ndf\": " << r.chi2_ndf << ", "
+            << "\"ks_d\": " << r.ks_d << ", \"n_empty_bin\": " << r.n_empty_bin << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    if (!out)
+    {
+        throw std::runtime_error("Unable to write " + std::string(file_name.Data()));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TH1::AddDirectory(false);
+
+    long n = argc > 1 ? TString(argv[1]).Atoll() : DEFAULT_N_SAMPLES;
+    TString json_name = argc > 2 ? argv[2] : "bench_pdfs.json";
+    TString sl_name = argc > 3 ? argv[3] : "pdf_sl.root";
+    TString dl_name = argc > 4 ? argv[4] : "pdf_dl.root";
+
+    std::vector<BenchResult> results;
+    BenchChannel("sl", sl_name, pdf1d_sl_names, pdf2d_sl_names, n, results);
+    BenchChannel("dl", dl_name, pdf1d_dl_names, pdf2d_dl_names, n, results);
+    WriteJSON(json_name, n, results);
+
+    std::cout << "Results written to " << json_name << "\n";
+    return 0;
+}
@@ -0,0 +1,287 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1.h"
+#include "TRandom3.h"
+#include "TString.h"
+
+#include "Constants.hpp"
+#include "PDFBundle.hpp"
+#include "Storage.hpp"
+#include "Estimator.hpp"
+#include "EstimatorUtils.hpp"
+#include "SelectionUtils.hpp"
+
+// histogram sampling vs spline-smoothed CDF sampling of 1d PDFs (SMOOTH_PDF)
+//
+// pdf mode: number of samples needed for a stable peak of every sampled 1d PDF, both samplings in one run
+// peak is the maximum bin of the samples binned like the PDF itself, it is stable when its RMS over trials
+// is below PDF bin width; finer output binning would favour smooth sampling, since histogram sampling is flat within a bin
+// usage: bench_smooth <sl|dl> <pdf_file.root|pdf_file.bundle> [n_trials]
+//
+// mass mode: convergence of estimator mass peak over iterations in SL channel with eqns method
+// sampling is selected at build time, so run it from builds with and without SMOOTH_PDF (and without EARLY_STOP):
+//   make clean && make bench_smooth && ./bench_smooth mass nano_sl_M800.root pdf_sl.root
+//   make clean && make SMOOTH_PDF=1 bench_smooth && ./bench_smooth mass nano_sl_M800.root pdf_sl.root
+// every selected event is estimated n_trials times continuing the random stream, peak of every combination is recorded
+// at PEAK_CHECKPOINTS iterations; per checkpoint RMS of peak over trials is averaged over combinations of all events
+// usage: bench_smooth mass <input_sl.root> <pdf_sl.root|pdf_sl.bundle> [n_events] [n_trials]
+
+inline constexpr int DEFAULT_N_TRIALS = 50;
+inline static const std::vector<int> N_SAMPLES = { 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000 };
+
+inline constexpr int DEFAULT_N_EVENTS = 200;
+inline constexpr int DEFAULT_N_MASS_TRIALS = 10;
+inline static const std::vector<int> PEAK_CHECKPOINTS = { 50, 100, 200, 300, 500, 700, N_ITER };
+
+PDFBundle LoadBundle(TString const& file_name, std::vector<TString> const& names)
+{
+    if (file_name.EndsWith(".bundle"))
+    {
+        return PDFBundle::Open(file_name);
+    }
+
+    std::unique_ptr<TFile> file(TFile::Open(file_name));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to open " + std::string(file_name.Data()));
+    }
+
+    std::vector<std::unique_ptr<TH1>> hists;
+    std::vector<TH1 const*> hist_ptrs;
+    for (auto const& name: names)
+    {
+        std::unique_ptr<TH1> hist(file->Get<TH1>(name));
+        if (!hist)
+        {
+            throw std::runtime_error("PDF " + std::string(name.Data()) + " is missing in " + std::string(file_name.Data()));
+        }
+        hist->SetDirectory(nullptr);
+        hist_ptrs.push_back(hist.get());
+        hists.push_back(std::move(hist));
+    }
+    return PDFBundle::FromHists(hist_ptrs);
+}
+
+// RMS of peak position over trials with n_samples each
+double PeakRMS(PDF1DView const& pdf, bool smooth, int n_samples, int n_trials, TRandom3& rng)
+{
+    size_t n_out = pdf.nbins;
+    double out_width = (pdf.xmax - pdf.xmin)/n_out;
+    std::vector<unsigned> counts(n_out);
+
+    double sum = 0.0;
+    double sum2 = 0.0;
+    for (int trial = 0; trial < n_trials; ++trial)
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int i = 0; i < n_samples; ++i)
+        {
+            double x = smooth ? pdf.SampleSmooth(&rng) : pdf.Sample(&rng);
+            double pos = (x - pdf.xmin)/out_width;
+            if (pos >= 0.0 && pos < n_out)
+            {
+                ++counts[static_cast<size_t>(pos)];
+            }
+        }
+
+        size_t peak_bin = std::max_element(counts.begin(), counts.end()) - counts.begin();
+        double peak = pdf.xmin + (peak_bin + 0.5)*out_width;
+        sum += peak;
+        sum2 += peak*peak;
+    }
+
+    double mean = sum/n_trials;
+    return std::sqrt(std::max(0.0, sum2/n_trials - mean*mean));
+}
+
+int MassPeakConvergence(TString const& input_name, TString const& pdf_file_name, int n_events, int n_trials)
+{
+    std::unique_ptr<TFile> file(TFile::Open(input_name));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to open " + std::string(input_name.Data()));
+    }
+    TTree* tree = file->Get<TTree>("Events");
+    if (!tree)
+    {
+        throw std::runtime_error("No tree Events in " + std::string(input_name.Data()));
+    }
+
+    Storage storage;
+    storage.ConnectTree(tree, Channel::SL);
+
+    EstimatorSingleLep estimator(pdf_file_name, Method::Eqns);
+    estimator.SetPeakCheckpoints(PEAK_CHECKPOINTS);
+
+    size_t n_cp = PEAK_CHECKPOINTS.size();
+    std::vector<double> sum_rms(n_cp, 0.0);
+    std::vector<double> sum_rel_rms(n_cp, 0.0);
+    std::vector<int> n_comb(n_cp, 0);
+
+    int n_selected = 0;
+    Long64_t n_entries = tree->GetEntries();
+    for (Long64_t evt = 0; evt < n_entries && n_selected < n_events; ++evt)
+    {
+        tree->GetEntry(evt);
+        if (storage.eventId % 2 != 1 || !IsRecoverable(storage, Channel::SL))
+        {
+            continue;
+        }
+
+        VecLVF_t jets = GetRecoJetP4(storage);
+        VecLVF_t leptons = GetRecoLepP4(storage, Channel::SL);
+        LorentzVectorF_t met = GetRecoMET(storage);
+        if (!IsFiducial(storage, jets, Channel::SL))
+        {
+            continue;
+        }
+        ++n_selected;
+
+        // traces[trial][comb][checkpoint], combinations are visited in the same order in every trial
+        std::vector<std::vector<std::vector<Float_t>>> traces;
+        for (int t = 0; t < n_trials; ++t)
+        {
+            TString chosen_comb;
+            estimator.ClearPeakTraces();
+            estimator.EstimateMass(jets, leptons, met, evt, chosen_comb);
+            traces.push_back(estimator.GetPeakTraces());
+        }
+
+        size_t n_traces = traces.front().size();
+        for (size_t c = 0; c < n_traces; ++c)
+        {
+            for (size_t k = 0; k < n_cp; ++k)
+            {
+                double sum = 0.0;
+                double sum2 = 0.0;
+                bool has_peak = true;
+                for (auto const& trial: traces)
+                {
+                    double peak = k < trial[c].size() ? trial[c][k] : -1.0;
+                    has_peak = has_peak && peak > 0.0;
+                    sum += peak;
+                    sum2 += peak*peak;
+                }
+
+                // combination counts once it has a peak in every trial
+                if (!has_peak)
+                {
+                    continue;
+                }
+                double mean = sum/n_trials;
+                double rms = std::sqrt(std::max(0.0, sum2/n_trials - mean*mean));
+                sum_rms[k] += rms;
+                sum_rel_rms[k] += rms/mean;
+                ++n_comb[k];
+            }
+        }
+    }
+
+    #ifdef SMOOTH_PDF
+        std::cout << "sampling: spline-smoothed CDF (SMOOTH_PDF)\n";
+    #else
+        std::cout << "sampling: histogram CDF\n";
+    #endif
+    std::cout << "mass peak RMS over " << n_trials << " trials, " << n_selected << " events, mass bin width " << (MAX_MASS - MIN_MASS)/N_BINS << " GeV\n";
+    std::cout << std::setw(12) << "iterations" << std::setw(14) << "combinations" << std::setw(16) << "peak rms, GeV" << std::setw(16) << "rel peak rms" << "\n";
+    for (size_t k = 0; k < n_cp; ++k)
+    {
+        double n = std::max(n_comb[k], 1);
+        std::cout << std::setw(12) << PEAK_CHECKPOINTS[k] << std::setw(14) << n_comb[k]
+                  << std::setw(16) << sum_rms[k]/n << std::setw(16) << sum_rel_rms[k]/n << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <sl|dl> <pdf_file.root|pdf_file.bundle> [n_trials]\n"
+                  << "       " << argv[0] << " mass <input_sl.root> <pdf_sl.root|pdf_sl.bundle> [n_events] [n_trials]\n";
+        return 1;
+    }
+
+    TH1::AddDirectory(false);
+
+    TString channel = argv[1];
+    if (channel == "mass")
+    {
+        if (argc < 4)
+        {
+            std::cout << "Usage: " << argv[0] << " mass <input_sl.root> <pdf_sl.root|pdf_sl.bundle> [n_events] [n_trials]\n";
+            return 1;
+        }
+        int n_events = argc > 4 ? TString(argv[4]).Atoi() : DEFAULT_N_EVENTS;
+        int n_trials = argc > 5 ? TString(argv[5]).Atoi() : DEFAULT_N_MASS_TRIALS;
+        return MassPeakConvergence(argv[2], argv[3], n_events, n_trials);
+    }
+
+    TString file_name = argv[2];
+    int n_trials = argc > 3 ? TString(argv[3]).Atoi() : DEFAULT_N_TRIALS;
+
+    std::vector<TString> names;
+    if (channel == "sl")
+    {
+        for (auto const& [pdf, name]: pdf1d_sl_names)
+        {
+            names.push_back(name);
+        }
+    }
+    else if (channel == "dl")
+    {
+        for (auto const& [pdf, name]: pdf1d_dl_names)
+        {
+            names.push_back(name);
+        }
+    }
+    else
+    {
+        std::cout << "Unknown channel " << channel << "\n";
+        return 1;
+    }
+    std::sort(names.begin(), names.end());
+
+    PDFBundle bundle = LoadBundle(file_name, names);
+    TRandom3 rng(SEED);
+
+    std::cout << "samples needed for peak RMS below PDF bin width (" << n_trials << " trials), -1 if not reached\n";
+    std::cout << std::setw(20) << "pdf" << std::setw(12) << "hist" << std::setw(12) << "smooth"
+              << std::setw(16) << "hist rms" << std::setw(16) << "smooth rms" << "\n";
+    for (auto const& name: names)
+    {
+        PDF1DView pdf = bundle.Get1D(name);
+        if (pdf.IsEmpty())
+        {
+            continue;
+        }
+
+        double out_width = (pdf.xmax - pdf.xmin)/pdf.nbins;
+        std::array<int, 2> n_stable = {-1, -1};
+        std::array<double, 2> last_rms = {0.0, 0.0};
+        for (int smooth = 0; smooth < 2; ++smooth)
+        {
+            for (int n: N_SAMPLES)
+            {
+                last_rms[smooth] = PeakRMS(pdf, smooth, n, n_trials, rng);
+                if (n_stable[smooth] < 0 && last_rms[smooth] < out_width)
+                {
+                    n_stable[smooth] = n;
+                }
+            }
+        }
+
+        std::cout << std::setw(20) << name << std::setw(12) << n_stable[0] << std::setw(12) << n_stable[1]
+                  << std::setw(16) << last_rms[0] << std::setw(16) << last_rms[1] << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <stdexcept>
+
+#include "TROOT.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TH1.h"
+#include "TString.h"
+
+// statistical comparison of 1d histograms with the same name in two files written by HistManager::Write,
+// e.g. hme_mass_sl/hme_mass_dl of analysis built with and without FAST_MATH:
+//   make clean && make analysis && ./analysis eqns uniform hists_ref.root
+//   make clean && make FAST_MATH=1 analysis && ./analysis eqns uniform hists_fast.root
+//   ./compare_hists hists_ref.root hists_fast.root hme_mass_sl hme_mass_dl
+// per histogram prints entries, mean and std dev in both files, Kolmogorov-Smirnov and chi2 (unweighted, normalized) p-values
+// returns 1 if any p-value is below P_VALUE_THRESHOLD
+// usage: compare_hists <reference.root> <test.root> [hist names...], all common 1d histograms by default
+
+inline constexpr double P_VALUE_THRESHOLD = 0.05;
+
+std::unique_ptr<TFile> OpenFile(std::string const& file_name)
+{
+    std::unique_ptr<TFile> file(TFile::Open(file_name.c_str()));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to open file " + file_name);
+    }
+    return file;
+}
+
+std::vector<std::string> ReadHistNames(TFile* file)
+{
+    std::vector<std::string> names;
+    for (TObject* obj: *file->GetListOfKeys())
+    {
+        TKey* key = static_cast<TKey*>(obj);
+        TString class_name = key->GetClassName();
+        if (class_name.BeginsWith("TH1"))
+        {
+            names.push_back(key->GetName());
+        }
+    }
+    return names;
+}
+
+int main(int argc, char* argv[])
+{
+    gROOT->ProcessLine("gErrorIgnoreLevel = 6001;");
+    TH1::AddDirectory(false);
+
+    if (argc < 3)
+    {
+        std::cerr << "usage: compare_hists <reference.root> <test.root> [hist names...]\n";
+        return 1;
+    }
+
+    std::unique_ptr<TFile> ref_file = OpenFile(argv[1]);
+    std::unique_ptr<TFile> test_file = OpenFile(argv[2]);
+
+    std::vector<std::string> names;
+    for (int i = 3; i < argc; ++i)
+    {
+        names.push_back(argv[i]);
+    }
+    if (names.empty())
+    {
+        names = ReadHistNames(ref_file.get());
+    }
+
+    int n_failed = 0;
+    for (auto const& name: names)
+    {
+        std::unique_ptr<TH1> ref(ref_file->Get<TH1>(name.c_str()));
+        std::unique_ptr<TH1> test(test_file->Get<TH1>(name.c_str()));
+        if (!ref || !test)
+        {
+            std::cout << name << ": missing in " << (ref ? argv[2] : argv[1]) << "\n";
+            ++n_failed;
+            continue;
+        }
+
+        double p_ks = ref->KolmogorovTest(test.get());
+        double p_chi2 = ref->Chi2Test(test.get(), "UU NORM");
+        bool compatible = p_ks >= P_VALUE_THRESHOLD && p_chi2 >= P_VALUE_THRESHOLD;
+        n_failed += !compatible;
+
+        std::cout << name << ": entries " << ref->GetEntries() << " vs " << test->GetEntries()
+                  << ", mean " << ref->GetMean() << " vs " << test->GetMean()
+                  << ", std dev " << ref->GetStdDev() << " vs " << test->GetStdDev()
+                  << ", KS p=" << p_ks << ", chi2 p=" << p_chi2
+                  << (compatible ? "" : " <- differ") << "\n";
+    }
+
+    return n_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TString.h"
+
+#include "Constants.hpp"
+#include "Storage.hpp"
+#include "ImageTransformer.hpp"
+
+// writes sparse (eta, phi) image of every event of input file to img_tree of output file
+// usage: images [input.root] [sl|dl] [output.root]
+
+int main(int argc, char* argv[])
+{
+    gROOT->ProcessLine("gErrorIgnoreLevel = 6001;");
+
+    TString input = argc > 1 ? argv[1] : "nano_sl_M800.root";
+    Channel ch = argc > 2 && TString(argv[2]) == "dl" ? Channel::DL : Channel::SL;
+    TString output = argc > 3 ? argv[3] : "images.root";
+
+    std::unique_ptr<TFile> file(TFile::Open(input));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to open file " + std::string(input.Data()));
+    }
+    TTree* tree = file->Get<TTree>("Events");
+    if (!tree)
+    {
+        throw std::runtime_error("No Events tree in " + std::string(input.Data()));
+    }
+
+    Storage storage;
+    storage.ConnectTree(tree, ch);
+
+    Long64_t n_events = tree->GetEntries();
+    {
+        ImageTransformer transformer(output);
+        for (Long64_t evt = 0; evt < n_events; ++evt)
+        {
+            transformer.Transform(storage, tree, evt);
+        }
+    }
+
+    std::cout << n_events << " images written to " << output << "\n";
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "TROOT.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TString.h"
+
+#include "HistManager.hpp"
+
+// renders PNGs of all histograms in a file written by HistManager::Write, e.g. histograms.root of analysis
+// histograms are split between n_workers forked processes, every worker opens the file and draws its share,
+// so drawing runs in parallel without sharing ROOT graphics state between threads
+// usage: render_hists <histograms.root> [output_dir] [n_workers]
+
+struct HistKey
+{
+    std::string name;
+    bool is_2d = false;
+};
+
+std::vector<HistKey> ReadKeys(std::string const& file_name)
+{
+    std::unique_ptr<TFile> file(TFile::Open(file_name.c_str()));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to open file " + file_name);
+    }
+
+    std::vector<HistKey> keys;
+    for (TObject* obj: *file->GetListOfKeys())
+    {
+        TKey* key = static_cast<TKey*>(obj);
+        TString class_name = key->GetClassName();
+        if (class_name.BeginsWith("TH2"))
+        {
+            keys.push_back({key->GetName(), true});
+        }
+        else if (class_name.BeginsWith("TH1"))
+        {
+            keys.push_back({key->GetName(), false});
+        }
+    }
+    return keys;
+}
+
+// draws keys worker, worker + n_workers, ...; returns number of failures
+int Render(std::string const& file_name, std::vector<HistKey> const& keys, std::string const& output_dir, int worker, int n_workers)
+{
+    gROOT->SetBatch(true);
+    TH1::AddDirectory(false);
+
+    std::unique_ptr<TFile> file(TFile::Open(file_name.c_str()));
+    if (!file || file->IsZombie())
+    {
+        std::cerr << "worker " << worker << ": unable to open file " << file_name << "\n";
+        return 1;
+    }
+
+    int n_failed = 0;
+    for (size_t i = worker; i < keys.size(); i += n_workers)
+    {
+        HistKey const& key = keys[i];
+        std::unique_ptr<TH1> hist(file->Get<TH1>(key.name.c_str()));
+        if (!hist)
+        {
+            ++n_failed;
+            continue;
+        }
+
+        if (key.is_2d)
+        {
+            SaveHist2D(static_cast<TH2*>(hist.get()), output_dir);
+        }
+        else
+        {
+            SaveHist1D(hist.get(), output_dir);
+        }
+    }
+    return n_failed;
+}
+
+int main(int argc, char* argv[])
+{
+    gROOT->ProcessLine("gErrorIgnoreLevel = 6001;");
+
+    if (argc < 2)
+    {
+        std::cerr << "usage: render_hists <histograms.root> [output_dir] [n_workers]\n";
+        return 1;
+    }
+
+    std::string file_name = argv[1];
+    std::string output_dir = argc > 2 ? argv[2] : "histograms";
+    int n_workers = argc > 3 ? std::stoi(argv[3]) : std::max(1u, std::thread::hardware_concurrency());
+    std::filesystem::create_directories(output_dir);
+
+    std::vector<HistKey> keys = ReadKeys(file_name);
+    n_workers = std::max(1, std::min<int>(n_workers, keys.size()));
+
+    std::vector<pid_t> workers;
+    for (int w = 0; w < n_workers; ++w)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            throw std::runtime_error("Unable to start worker process");
+        }
+        if (pid == 0)
+        {
+            int n_failed = Render(file_name, keys, output_dir, w, n_workers);
+            _exit(n_failed == 0 ? 0 : 1);
+        }
+        workers.push_back(pid);
+    }
+
+    int n_failed_workers = 0;
+    for (pid_t pid: workers)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        n_failed_workers += !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    std::cout << "rendered " << keys.size() << " histograms from " << file_name << " to " << output_dir << " with " << n_workers << " workers\n";
+    if (n_failed_workers > 0)
+    {
+        std::cerr << n_failed_workers << " workers failed\n";
+        return 1;
+    }
+    return 0;
+}
@@ -13,22 +13,10 @@
 #include "HistManager.hpp"
 #include "EstimatorTools.hpp"
 #include "CombTools.hpp"
+#include "P2Quantile.hpp"
 
 static constexpr int N_RECO_JETS = 12;
 
-double InterquantileRange(std::unique_ptr<TH1F> const& h, unsigned l = 16, unsigned r = 84)
-{
-    int const nq = 100;
-    double xq[nq];  // position where to compute the quantiles in [0,1]
-    double yq[nq];  // array to contain the quantiles
-    for (int i = 0; i < nq; ++i) 
-    {
-        xq[i] = static_cast<double>(i+1)/nq;
-    }
-    h->GetQuantiles(nq, yq, xq);
-    return yq[r - 1] - yq[l - 1];
-}
-
 int main()
 {
     std::cout << std::setprecision(4);
@@ -234,6 +222,8 @@ int main()
     hm.Add(hme_mass, "HME X->HH mass", {"X->HH mass, [GeV]", "Count"}, {0, 2500}, 100);
 
     auto h = std::make_unique<TH1F>("h", "h", 200, 0, 2500);
+    P2Quantile q16(0.16);
+    P2Quantile q84(0.84);
 
     int hme_events = 0;
     int hme_worked = 0;
@@ -381,6 +371,8 @@ int main()
             hm.Fill(hme_mass, estimations[idx]);
             // hm.Fill(hme_integral, *it);
             h->Fill(estimations[idx]);
+            q16.Add(estimations[idx]);
+            q84.Add(estimations[idx]);
 
             // hm.Fill(mass_vs_int_2d, estimations[idx], *it);
 
@@ -398,7 +390,7 @@ int main()
     std::cout << "Finished processing, total events = " << nEvents << "\n";
     std::cout << "Events passed to HME = " << hme_events << "\n"; 
     std::cout << "HME successful = " << 100.0*hme_worked/hme_events << "%\n"; 
-    std::cout << "HME width = " << InterquantileRange(h) << "\n";
+    std::cout << "HME width = " << q84.Get() - q16.Get() << "\n";
     std::cout << "HME value = " << h->GetXaxis()->GetBinCenter(h->GetMaximumBin()) << "\n";
     std::cout << "Processing time = " << elapsed.count() << " s\n";
 
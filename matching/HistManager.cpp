@@ -7,37 +7,47 @@
 #include "TString.h"
 #include "TFile.h"
 
-void HistManager::Add(std::string hist_name, std::string const& title, Label const& labels, Range const& range, int n_bins)
+Hist1DHandle HistManager::Add(std::string hist_name, std::string const& title, Label const& labels, Range const& range, int n_bins)
 {
-    m_hists_1d.insert({std::move(hist_name), MakeItem1D(hist_name, title, labels, range, n_bins)});
+    auto [it, inserted] = m_index_1d.insert({hist_name, static_cast<int>(m_hists_1d.size())});
+    if (inserted)
+    {
+        m_hists_1d.push_back(MakeItem1D(hist_name, title, labels, range, n_bins));
+    }
+    return Hist1DHandle(it->second);
 }
 
-void HistManager::Add(std::string hist_name, std::string const& title, Label const& labels, Range const& xrange, Range const& yrange, Bins const& bins)
+Hist2DHandle HistManager::Add(std::string hist_name, std::string const& title, Label const& labels, Range const& xrange, Range const& yrange, Bins const& bins)
 {
-    m_hists_2d.insert({std::move(hist_name), MakeItem2D(hist_name, title, labels, xrange, yrange, bins)});
+    auto [it, inserted] = m_index_2d.insert({hist_name, static_cast<int>(m_hists_2d.size())});
+    if (inserted)
+    {
+        m_hists_2d.push_back(MakeItem2D(hist_name, title, labels, xrange, yrange, bins));
+    }
+    return Hist2DHandle(it->second);
 }
 
 void HistManager::Fill(std::string const& hist_name, double value)
 {
-    auto const& [hist, hist_info] = m_hists_1d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_1d[m_index_1d.at(hist_name)]; 
     hist->Fill(value);
 }
 
 void HistManager::Fill(std::string const& hist_name, double xval, double yval)
 {
-    auto const& [hist, hist_info] = m_hists_2d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_2d[m_index_2d.at(hist_name)]; 
     hist->Fill(xval, yval);
 }
 
 void HistManager::FillWeighted(std::string const& hist_name, double value, double weight)
 {
-    auto const& [hist, hist_info] = m_hists_1d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_1d[m_index_1d.at(hist_name)]; 
     hist->Fill(value, weight);
 }
 
 void HistManager::FillWeighted(std::string const& hist_name, double xval, double yval, double weight)
 {
-    auto const& [hist, hist_info] = m_hists_2d.at(hist_name); 
+    auto const& [hist, hist_info] = m_hists_2d[m_index_2d.at(hist_name)]; 
     hist->Fill(xval, yval, weight);
 }
 
@@ -51,9 +61,9 @@ void HistManager::Draw() const
     auto gStyle = std::make_unique<TStyle>();
     gStyle->SetPalette(kRainBow);
 
-    for (auto const& [hist_name, hhi_pair]: m_hists_1d)
+    for (auto const& [ptr_hist, hist_info]: m_hists_1d)
     {
-        auto const& [ptr_hist, hist_info] = hhi_pair;
+        std::string hist_name = ptr_hist->GetName();
         auto const& [title, labels, range, nbins] = hist_info;
         auto const& [xlabel, ylabel] = labels;
 
@@ -67,9 +77,9 @@ void HistManager::Draw() const
         // c1->SaveAs(Form("%s/%s.png", m_path.c_str(), hist_name.c_str()));
     }
 
-    for (auto const& [hist_name, hhi_pair]: m_hists_2d)
+    for (auto const& [ptr_hist, hist_info]: m_hists_2d)
     {
-        auto const& [ptr_hist, hist_info] = hhi_pair;
+        std::string hist_name = ptr_hist->GetName();
         auto const& [title, labels, xrange, yrange, bins] = hist_info;
         auto const& [xlabel, ylabel] = labels;
         // auto c1 = std::make_unique<TCanvas>("c1", "c1");
@@ -103,7 +113,7 @@ void HistManager::DrawStack(std::vector<std::string> const& names, std::string c
     { 
         try
         {
-            auto const& [ptr_hist, hist_info] = m_hists_1d.at(name); 
+            auto const& [ptr_hist, hist_info] = m_hists_1d[m_index_1d.at(name)]; 
             auto const& [title, labels, range, nbins] = hist_info;
             auto const& [xlabel, ylabel] = labels;
 
@@ -136,7 +146,7 @@ void HistManager::Write1D(std::string const& fname, std::vector<std::string> con
     auto output = std::make_unique<TFile>(fname.c_str(), "RECREATE");
     for (auto const& name: names)
     {
-        auto const& [ptr_hist, hist_info] = m_hists_1d.at(name);
+        auto const& [ptr_hist, hist_info] = m_hists_1d[m_index_1d.at(name)];
         int binmax = ptr_hist->GetMaximumBin();
         double content = ptr_hist->GetBinContent(binmax);
         ptr_hist->Scale(1.0/content);
@@ -151,7 +161,7 @@ void HistManager::Write2D(std::string const& fname, std::vector<std::string> con
     auto output = std::make_unique<TFile>(fname.c_str(), "UPDATE");
     for (auto const& name: names)
     {
-        auto const& [ptr_hist, hist_info] = m_hists_2d.at(name);
+        auto const& [ptr_hist, hist_info] = m_hists_2d[m_index_2d.at(name)];
         ptr_hist->Write();
     }
 	output->Write();
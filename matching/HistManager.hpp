@@ -2,6 +2,8 @@
 #define HIST_MAN_HPP
 
 #include <unordered_map>
+#include <vector>
+#include <string>
 #include <memory>
 
 #include "TH1.h"
@@ -9,6 +11,22 @@
 // #include "TCanvas.h"
 // #include "TFile.h"
 
+// returned by HistManager::Add, filling by handle is one indexed access into the array of histograms, name is not hashed
+// handles are made only by HistManager::Add, so every handle refers to a registered histogram
+class Hist1DHandle
+{
+    friend class HistManager;
+    explicit Hist1DHandle(int i) : idx(i) {}
+    int idx;
+};
+
+class Hist2DHandle
+{
+    friend class HistManager;
+    explicit Hist2DHandle(int i) : idx(i) {}
+    int idx;
+};
+
 class HistManager
 {
     private:
@@ -71,8 +89,11 @@ class HistManager
         return {Make2DHist(hist_name, title, xrange, yrange, bins), Make2DInfo(title, labels, xrange, yrange, bins)};
     }
 
-    std::unordered_map<std::string, Item1D> m_hists_1d;
-    std::unordered_map<std::string, Item2D> m_hists_2d;
+    // histograms are stored in order of registration, names map to their positions
+    std::vector<Item1D> m_hists_1d;
+    std::vector<Item2D> m_hists_2d;
+    std::unordered_map<std::string, int> m_index_1d;
+    std::unordered_map<std::string, int> m_index_2d;
     
     // std::unique_ptr<TCanvas> m_c1;
     // std::unique_ptr<TFile> m_outfile;
@@ -81,12 +102,20 @@ class HistManager
     public:
     // HistManager(std::string const& path, std::string const& outfile);
 
-    void Add(std::string hist_name, std::string const& title, Label const& labels, Range const& range, int n_bins);
-    void Add(std::string hist_name, std::string const& title, Label const& labels, Range const& xrange, Range const& yrange, Bins const& bins);
+    // histogram with already registered name is not replaced, its handle is returned
+    Hist1DHandle Add(std::string hist_name, std::string const& title, Label const& labels, Range const& range, int n_bins);
+    Hist2DHandle Add(std::string hist_name, std::string const& title, Label const& labels, Range const& xrange, Range const& yrange, Bins const& bins);
     void Fill(std::string const& hist_name, double value);
     void Fill(std::string const& hist_name, double xval, double yval);
     void FillWeighted(std::string const& hist_name, double value, double weight);
     void FillWeighted(std::string const& hist_name, double xval, double yval, double weight);
+    inline void Fill(Hist1DHandle h, double value) { m_hists_1d[h.idx].first->Fill(value); }
+    inline void Fill(Hist2DHandle h, double xval, double yval) { m_hists_2d[h.idx].first->Fill(xval, yval); }
+    inline void FillWeighted(Hist1DHandle h, double value, double weight) { m_hists_1d[h.idx].first->Fill(value, weight); }
+    inline void FillWeighted(Hist2DHandle h, double xval, double yval, double weight) { m_hists_2d[h.idx].first->Fill(xval, yval, weight); }
+    // n values with unit weights in one call
+    inline void FillN(Hist1DHandle h, double const* values, int n) { m_hists_1d[h.idx].first->FillN(n, values, nullptr); }
+    inline void FillN(Hist1DHandle h, std::vector<double> const& values) { FillN(h, values.data(), values.size()); }
     void Draw() const;
     void DrawStack(std::vector<std::string> const& names, std::string const& title, std::string const& name) const;
     void Write1D(std::string const& fname, std::vector<std::string> const& names) const;
@@ -1,11 +1,11 @@
 #include "MatchingTools.hpp"
 
-#include <map>
-
 #include "TString.h"
 #include "TCanvas.h"
 #include "TLegend.h"
 
+#include "DeltaRMatrix.hpp"
+
 void Print(TLorentzVector const& p, bool EXYZ)
 {
     if (EXYZ) 
@@ -18,6 +18,232 @@ void Print(TLorentzVector const& p, bool EXYZ)
     }
 }
 
+void GenParticleGraph::Build(int const* mothers, int n_gen_part)
+{
+    m_n = n_gen_part;
+    m_mothers.assign(mothers, mothers + n_gen_part);
+    for (int i = 0; i < m_n; ++i)
+    {
+        if (m_mothers[i] < 0 || m_mothers[i] >= m_n || m_mothers[i] == i)
+        {
+            m_mothers[i] = -1;
+        }
+    }
+
+    // counting sort of particles by mother, children keep increasing index order
+    m_child_begin.assign(m_n + 1, 0);
+    for (int i = 0; i < m_n; ++i)
+    {
+        if (m_mothers[i] != -1)
+        {
+            ++m_child_begin[m_mothers[i] + 1];
+        }
+    }
+    for (int i = 0; i < m_n; ++i)
+    {
+        m_child_begin[i + 1] += m_child_begin[i];
+    }
+
+    // m_end is used as fill cursor before traversal
+    m_children.resize(m_child_begin[m_n]);
+    m_end.assign(m_child_begin.begin(), m_child_begin.end() - 1);
+    for (int i = 0; i < m_n; ++i)
+    {
+        if (m_mothers[i] != -1)
+        {
+            m_children[m_end[m_mothers[i]]++] = i;
+        }
+    }
+
+    // iterative depth-first traversal from roots, ~idx on the stack marks exit from idx
+    // particles on mother cycles are not reachable from roots and start their own trees
+    m_pos.assign(m_n, -1);
+    m_end.assign(m_n, 0);
+    m_depth.assign(m_n, 0);
+    m_stable.clear();
+    m_stable_count.assign(m_n + 1, 0);
+    int next_pos = 0;
+    auto traverse = [this, &next_pos](int root)
+    {
+        m_stack.push_back(root);
+        while (!m_stack.empty())
+        {
+            int idx = m_stack.back();
+            m_stack.pop_back();
+            if (idx < 0)
+            {
+                m_end[~idx] = next_pos;
+                continue;
+            }
+
+            m_stable_count[next_pos] = m_stable.size();
+            m_pos[idx] = next_pos++;
+            if (IsStable(idx))
+            {
+                m_stable.push_back(idx);
+            }
+
+            m_stack.push_back(~idx);
+            for (int c = m_child_begin[idx + 1] - 1; c >= m_child_begin[idx]; --c)
+            {
+                int child = m_children[c];
+                if (m_pos[child] == -1)
+                {
+                    m_depth[child] = m_depth[idx] + 1;
+                    m_stack.push_back(child);
+                }
+            }
+        }
+    };
+
+    for (int i = 0; i < m_n; ++i)
+    {
+        if (m_mothers[i] == -1)
+        {
+            traverse(i);
+        }
+    }
+    for (int i = 0; i < m_n; ++i)
+    {
+        if (m_pos[i] == -1)
+        {
+            traverse(i);
+        }
+    }
+    m_stable_count[m_n] = m_stable.size();
+}
+
+DecayPattern::DecayPattern(DecayNode const& root, int n_slots)
+:   m_n_slots(n_slots)
+{
+    m_nodes.resize(1);
+    Compile(root, 0);
+}
+
+void DecayPattern::Compile(DecayNode const& node, int pos)
+{
+    int first_child = m_nodes.size();
+    int n_children = node.children.size();
+    m_nodes[pos] = { node.ids, node.abs_id, node.first_slot, node.last_slot, node.exact, first_child, n_children };
+    m_nodes.resize(first_child + n_children);
+    for (int c = 0; c < n_children; ++c)
+    {
+        Compile(node.children[c], first_child + c);
+    }
+}
+
+bool DecayPattern::HasId(Node const& node, int pdg_id) const
+{
+    int id = node.abs_id ? std::abs(pdg_id) : pdg_id;
+    return std::find(node.ids.begin(), node.ids.end(), id) != node.ids.end();
+}
+
+std::vector<int> DecayPattern::Match(int const* pdg_ids, GenParticleGraph const& graph) const
+{
+    std::vector<int> slots(m_n_slots, -1);
+    for (int i = graph.Size() - 1; i >= 0; --i)
+    {
+        if (HasId(m_nodes[0], pdg_ids[i]) && MatchNode(0, i, pdg_ids, graph, slots))
+        {
+            return slots;
+        }
+    }
+    return {};
+}
+
+bool DecayPattern::MatchNode(int node_idx, int part_idx, int const* pdg_ids, GenParticleGraph const& graph, std::vector<int>& slots) const
+{
+    Node const& node = m_nodes[node_idx];
+    if (!HasId(node, pdg_ids[part_idx]))
+    {
+        return false;
+    }
+
+    int last = part_idx;
+    if (node.n_children > 0 || node.last_slot != -1)
+    {
+        bool has_copy = true;
+        while (has_copy)
+        {
+            has_copy = false;
+            for (int d: graph.Children(last))
+            {
+                if (pdg_ids[d] == pdg_ids[last])
+                {
+                    last = d;
+                    has_copy = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    auto daughters = graph.Children(last);
+    if (node.n_children > 0 && node.exact && static_cast<int>(daughters.size()) != node.n_children)
+    {
+        return false;
+    }
+    if (!MatchChildren(node, 0, daughters, 0, pdg_ids, graph, slots))
+    {
+        return false;
+    }
+
+    if (node.first_slot != -1)
+    {
+        slots[node.first_slot] = part_idx;
+    }
+    if (node.last_slot != -1)
+    {
+        slots[node.last_slot] = last;
+    }
+    return true;
+}
+
+// child-th child of node is tried on every daughter not used by previous children, in increasing index order
+// slots of failed attempts are overwritten by the successful one, which fills all slots of the subtree
+bool DecayPattern::MatchChildren(Node const& node, int child, GenParticleGraph::Range daughters, std::uint64_t used,
+                                 int const* pdg_ids, GenParticleGraph const& graph, std::vector<int>& slots) const
+{
+    if (child == node.n_children)
+    {
+        return true;
+    }
+
+    int n_daughters = std::min<int>(daughters.size(), 64);
+    for (int d = 0; d < n_daughters; ++d)
+    {
+        if ((used >> d) & 1)
+        {
+            continue;
+        }
+
+        if (MatchNode(node.first_child + child, daughters.first[d], pdg_ids, graph, slots)
+            && MatchChildren(node, child + 1, daughters, used | (1ULL << d), pdg_ids, graph, slots))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+DecayPattern const& SignalPatternSL()
+{
+    static DecayPattern const pattern(
+        { {RADION_ID}, false, -1, SIG::X, false,
+          { { {HIGGS_ID}, false, SIG::H_bb, -1, true,
+              { { {B_ID}, false, SIG::b, -1, true, {} },
+                { {BBAR_ID}, false, SIG::bbar, -1, true, {} } } },
+            { {HIGGS_ID}, false, SIG::H_WW, -1, true,
+              { { {W_ID}, true, SIG::LepWfirst, SIG::LepWlast, true,
+                  { { LEPTONS, true, SIG::l, -1, true, {} },
+                    { NEUTRINOS, true, SIG::nu, -1, true, {} } } },
+                { {W_ID}, true, SIG::HadWfirst, SIG::HadWlast, true,
+                  { { SIG_QUARKS, true, SIG::q1, -1, true, {} },
+                    { SIG_QUARKS, true, SIG::q2, -1, true, {} } } } } } } },
+        N_SIG_PART);
+    return pattern;
+}
+
 std::vector<int> GetNextGeneration(int part_idx, int const* mothers, int n_gen_part)
 {
     std::vector<int> gen;
@@ -30,33 +256,43 @@ std::vector<int> GetNextGeneration(int part_idx, int const* mothers, int n_gen_p
 }
 
 std::vector<std::vector<int>> GetDescendants(int part_idx, int const* mothers, int n_gen_part)
+{
+    return GetDescendants(part_idx, GenParticleGraph(mothers, n_gen_part));
+}
+
+std::vector<std::vector<int>> GetDescendants(int part_idx, GenParticleGraph const& graph)
 {
     std::vector<std::vector<int>> descendants;
+    if (!graph.IsValid(part_idx))
+    {
+        return descendants;
+    }
+
     descendants.push_back({part_idx});
-    // int gener_counter = 1;
-    auto cur_gen = GetNextGeneration(part_idx, mothers, n_gen_part);
-    while (!cur_gen.empty())
+    while (true)
     {
-        descendants.push_back(cur_gen);
         std::vector<int> next_gen;
-        for (auto const& part: cur_gen)
+        for (auto part: descendants.back())
         {
-            auto part_daughters = GetNextGeneration(part, mothers, n_gen_part);
-            next_gen.insert(next_gen.end(), part_daughters.begin(), part_daughters.end());
+            auto children = graph.Children(part);
+            next_gen.insert(next_gen.end(), children.begin(), children.end());
+        }
+        if (next_gen.empty())
+        {
+            break;
         }
-        // ++gener_counter;
-        cur_gen = next_gen;
+        descendants.push_back(std::move(next_gen));
     }
-    if (part_idx == -1) descendants.clear();
     return descendants;
 }
 
 std::vector<int> GetFinalParticles(int const* mothers, int n_gen_part)
 {
+    GenParticleGraph graph(mothers, n_gen_part);
     std::vector<int> finals;
     for (int i = 0; i < n_gen_part; ++i)
     {
-        if (GetNextGeneration(i, mothers, n_gen_part).empty()) 
+        if (graph.IsStable(i)) 
             finals.push_back(i);
     }
     return finals;
@@ -64,15 +300,20 @@ std::vector<int> GetFinalParticles(int const* mothers, int n_gen_part)
 
 std::vector<int> GetStableDescendants(int part_idx, int const* mothers, int n_gen_part)
 {
-    std::vector<int> res;
-    auto stable = GetFinalParticles(mothers, n_gen_part);
-    for (auto idx: stable)
+    return GetStableDescendants(part_idx, GenParticleGraph(mothers, n_gen_part));
+}
+
+// returned in increasing index order like in GetFinalParticles
+std::vector<int> GetStableDescendants(int part_idx, GenParticleGraph const& graph)
+{
+    if (!graph.IsValid(part_idx))
     {
-        if (IsDescOf(idx, part_idx, mothers))
-        {
-            res.push_back(idx);
-        }
+        return {};
     }
+
+    auto stable = graph.StableDescendants(part_idx);
+    std::vector<int> res(stable.begin(), stable.end());
+    std::sort(res.begin(), res.end());
     return res;
 }
 
@@ -114,9 +355,19 @@ int FindLast(int target_id, int const* pdg_ids, int n_gen_part)
 }
 
 std::vector<int> FindSpecificDescendants(std::vector<int> const& desc_range, int mother_idx, int const* mothers, int const* pdg_ids, int n_gen_part)
+{
+    return FindSpecificDescendants(desc_range, mother_idx, GenParticleGraph(mothers, n_gen_part), pdg_ids);
+}
+
+std::vector<int> FindSpecificDescendants(std::vector<int> const& desc_range, int mother_idx, GenParticleGraph const& graph, int const* pdg_ids)
 {
     std::vector<int> res;
-    auto descendants = GetNextGeneration(mother_idx, mothers, n_gen_part);
+    if (!graph.IsValid(mother_idx))
+    {
+        return res;
+    }
+
+    auto descendants = graph.Children(mother_idx);
     for (auto const& desc_pdg_id: desc_range)
     {
         for (auto const& idx: descendants)
@@ -129,109 +380,42 @@ std::vector<int> FindSpecificDescendants(std::vector<int> const& desc_range, int
 
 std::vector<int> GetSignal(int const* pdg_ids, int const* mothers, int n_gen_part)
 {
-    std::vector<int> res(N_SIG_PART, -1);
-    int rad_idx = FindLast(RADION_ID, pdg_ids, n_gen_part);
-    res[SIG::X] = rad_idx;
-    
-    // tmp vector to store generation being examined currently
-    auto tmp1 = FindSpecificDescendants({HIGGS_ID}, rad_idx, mothers, pdg_ids, n_gen_part);
-    // H0->hh only
-    if (tmp1.size() == 2)
-    {
-        res[SIG::H_bb] = tmp1[0];
-        res[SIG::H_WW] = tmp1[1];
-    }
+    return GetSignal(pdg_ids, GenParticleGraph(mothers, n_gen_part));
+}
 
-    tmp1 = GetNextGeneration(res[SIG::H_bb], mothers, n_gen_part); 
-    auto tmp2 = GetNextGeneration(res[SIG::H_WW], mothers, n_gen_part); 
+std::vector<int> GetSignal(int const* pdg_ids, GenParticleGraph const& graph)
+{
+    return SignalPatternSL().Match(pdg_ids, graph);
+}
 
-    tmp1.insert(tmp1.end(), tmp2.begin(), tmp2.end()); // now tmp1 contains indices of all daughters of both higgses or is empty;
-    
-    // hh->bbWW only!
-    int first_w_plus = -1;
-    int first_w_minus = -1;
-    if (tmp1.size() == 4)
+bool HasOnlyEleMu(std::vector<int> const& signal, int const* mothers, int const* pdg_ids)
+{
+    if (signal.size() != N_SIG_PART)
     {
-        if (std::abs(pdg_ids[tmp1[0]]) != B_ID)
-        {
-            std::swap(res[SIG::H_bb], res[SIG::H_WW]);
-        }
-
-        for (auto const& idx: tmp1)
-        {
-            if (pdg_ids[idx] == B_ID)
-            {
-                res[SIG::b] = idx;
-            }
-            else if (pdg_ids[idx] == BBAR_ID) 
-            {
-                res[SIG::bbar] = idx;
-            }
-            else if (pdg_ids[idx] == WPLUS_ID)
-            {
-                first_w_plus = idx;
-            }
-            else if (pdg_ids[idx] == WMINUS_ID)
-            {
-                first_w_minus = idx;
-            }
-        }
+        return false;
     }
-
-    int wplus = FindLast(WPLUS_ID, pdg_ids, n_gen_part);
-    int wminus = FindLast(WMINUS_ID, pdg_ids, n_gen_part);
-    auto w_plus_daughters = GetNextGeneration(wplus, mothers, n_gen_part);
-    auto w_minus_daughters = GetNextGeneration(wminus, mothers, n_gen_part);
-
-    if (w_plus_daughters.size() == 2)
+    
+    for (auto s: signal)
     {
-        if (std::abs(pdg_ids[w_plus_daughters[0]]) <= B_ID && std::abs(pdg_ids[w_plus_daughters[1]]) <= B_ID)
+        if (pdg_ids[s] == RADION_ID)
         {
-            res[SIG::q1] = w_plus_daughters[0];
-            res[SIG::q2] = w_plus_daughters[1];
-            res[SIG::HadWlast] = wplus;
-            res[SIG::HadWfirst] = (IsDescOf(wplus, first_w_plus, mothers) || wplus == first_w_plus) ? first_w_plus : first_w_minus;
+            continue;
         }
-        else if (std::abs(pdg_ids[w_plus_daughters[0]]) > B_ID && std::abs(pdg_ids[w_plus_daughters[1]]) > B_ID)
+        if (!IsDescOf(s, signal[SIG::X], mothers))
         {
-            // res[SIG::l] = IsSigLep(pdg_ids[w_plus_daughters[0]]) ? w_plus_daughters[0] : w_plus_daughters[1];
-            // res[SIG::nu] = IsSigNu(pdg_ids[w_plus_daughters[1]]) ? w_plus_daughters[1] : w_plus_daughters[0];
-            res[SIG::l] = IsLep(pdg_ids[w_plus_daughters[0]]) ? w_plus_daughters[0] : w_plus_daughters[1];
-            res[SIG::nu] = IsNu(pdg_ids[w_plus_daughters[1]]) ? w_plus_daughters[1] : w_plus_daughters[0];
-            res[SIG::LepWlast] = wplus;
-            res[SIG::HadWfirst] = first_w_plus;
-            res[SIG::LepWfirst] = (IsDescOf(wplus, first_w_plus, mothers) || wplus == first_w_plus) ? first_w_plus : first_w_minus;
+            return false;
         }
     }
 
-    if (w_minus_daughters.size() == 2)
+    if (std::abs(pdg_ids[signal[SIG::l]]) == TAU_ID || std::abs(pdg_ids[signal[SIG::nu]]) == NU_TAU_ID)
     {
-        if (std::abs(pdg_ids[w_minus_daughters[0]]) <= B_ID && std::abs(pdg_ids[w_minus_daughters[1]]) <= B_ID)
-        {
-            res[SIG::q1] = w_minus_daughters[0];
-            res[SIG::q2] = w_minus_daughters[1];
-            res[SIG::HadWlast] = wminus;
-            res[SIG::HadWfirst] = (IsDescOf(wminus, first_w_minus, mothers) || wminus == first_w_minus) ? first_w_minus : first_w_plus;
-        }
-        else if (std::abs(pdg_ids[w_minus_daughters[0]]) > B_ID && std::abs(pdg_ids[w_minus_daughters[1]]) > B_ID)
-        {
-            // res[SIG::l] = IsSigLep(pdg_ids[w_minus_daughters[0]]) ? w_minus_daughters[0] : w_minus_daughters[1];
-            // res[SIG::nu] = IsSigNu(pdg_ids[w_minus_daughters[1]]) ? w_minus_daughters[1] : w_minus_daughters[0];
-            res[SIG::l] = IsLep(pdg_ids[w_minus_daughters[0]]) ? w_minus_daughters[0] : w_minus_daughters[1];
-            res[SIG::nu] = IsNu(pdg_ids[w_minus_daughters[1]]) ? w_minus_daughters[1] : w_minus_daughters[0];
-            res[SIG::LepWlast] = wminus;
-            res[SIG::LepWfirst] = (IsDescOf(wminus, first_w_minus, mothers) || wminus == first_w_minus) ? first_w_minus : first_w_plus;
-        }
+        return false;
     }
 
-    if (std::any_of(res.begin(), res.end(), [](int x){ return x == -1; })) 
-    {
-        res.clear();
-    }
-    return res;
+    return true;
 }
 
-bool HasOnlyEleMu(std::vector<int> const& signal, int const* mothers, int const* pdg_ids)
+bool HasOnlyEleMu(std::vector<int> const& signal, GenParticleGraph const& graph, int const* pdg_ids)
 {
     if (signal.size() != N_SIG_PART)
     {
@@ -244,13 +428,13 @@ bool HasOnlyEleMu(std::vector<int> const& signal, int const* mothers, int const*
         {
             continue;
         }
-        if (!IsDescOf(s, signal[SIG::X], mothers))
+        if (!graph.IsDescOf(s, signal[SIG::X]))
         {
             return false;
         }
     }
 
-    if (std::abs(signal[SIG::l]) == TAU_ID || std::abs(signal[SIG::nu]) == NU_TAU_ID)
+    if (std::abs(pdg_ids[signal[SIG::l]]) == TAU_ID || std::abs(pdg_ids[signal[SIG::nu]]) == NU_TAU_ID)
     {
         return false;
     }
@@ -278,51 +462,28 @@ TLorentzVector GetP4(KinematicData const& kd, int idx)
     return p;
 }
 
-int Match(int idx, KinematicData const& kd_part, KinematicData const& kd_jet)
+namespace
 {
-    TLorentzVector ppart = GetP4(kd_part, idx);
-    std::map<double, int> hash;
-    int n_jets = kd_jet.n;
-    for (int i = 0; i < n_jets; ++i)
+    // index of closest column to the only row of dr within DR_THRESH or -1
+    int ClosestWithinThresh(DeltaRMatrix const& dr)
     {
-        TLorentzVector pjet = GetP4(kd_jet, i);
-        double dr = ppart.DeltaR(pjet);
-        if (dr < DR_THRESH)
-        {
-            hash.insert({dr, i});
-        }
+        int idx = dr.ClosestCol(0);
+        return idx != -1 && dr.DR2(0, idx) < DR_THRESH*DR_THRESH ? idx : -1;
     }
+}
 
-    auto best_match = hash.begin();
-
-    if (best_match != hash.end())
-    {
-        return best_match->second;
-    }
-    return -1;
+int Match(int idx, KinematicData const& kd_part, KinematicData const& kd_jet)
+{
+    DeltaRMatrix dr;
+    dr.Fill(kd_part.eta + idx, kd_part.phi + idx, 1, kd_jet.eta, kd_jet.phi, kd_jet.n);
+    return ClosestWithinThresh(dr);
 }
 
 int Match(TLorentzVector const& quark, std::vector<TLorentzVector> const& jets)
 {
-    std::map<double, int> hash;
-    int n_jets = jets.size();
-    for (int i = 0; i < n_jets; ++i)
-    {
-        TLorentzVector const& jet = jets[i];
-        double dr = quark.DeltaR(jet);
-        if (dr < DR_THRESH)
-        {
-            hash.insert({dr, i});
-        }
-    }
-
-    auto best_match = hash.begin();
-
-    if (best_match != hash.end())
-    {
-        return best_match->second;
-    }
-    return -1;
+    DeltaRMatrix dr;
+    dr.Fill(quark, jets);
+    return ClosestWithinThresh(dr);
 }
 
 int FindSecondMatch(int first_match, TLorentzVector const& target, std::vector<TLorentzVector> const& jets)
@@ -350,14 +511,13 @@ int FindSecondMatch(int first_match, TLorentzVector const& target, std::vector<T
 
 std::vector<int> Matches(int idx, KinematicData const& kd_part, KinematicData const& kd_jet)
 {
+    DeltaRMatrix dr;
+    dr.Fill(kd_part.eta + idx, kd_part.phi + idx, 1, kd_jet.eta, kd_jet.phi, kd_jet.n);
+    float const* dr2 = dr.Row(0);
     std::vector<int> matches;
-    TLorentzVector p = GetP4(kd_part, idx);
-    int n_jets = kd_jet.n;
-    for (int i = 0; i < n_jets; ++i)
+    for (int i = 0; i < kd_jet.n; ++i)
     {
-        TLorentzVector j = GetP4(kd_jet, i);
-        double dr = p.DeltaR(j);
-        if (dr < DR_THRESH)
+        if (dr2[i] < DR_THRESH*DR_THRESH)
         {
             matches.push_back(i);
         }
@@ -367,125 +527,56 @@ std::vector<int> Matches(int idx, KinematicData const& kd_part, KinematicData co
 
 double MinDeltaR(std::vector<TLorentzVector> const& parts)
 {
+    DeltaRMatrix dr;
+    dr.Fill(parts, parts);
     int n = parts.size();
-    double min_dR = parts[0].DeltaR(parts[1]);
+    float min_dr2 = dr.DR2(0, 1);
     for (int i = 0; i < n; ++i)
     {
+        float const* row = dr.Row(i);
         for (int j = i + 1; j < n; ++j)
         {
-            double dr = parts[i].DeltaR(parts[j]);
-            if (dr < min_dR)
-            {
-                min_dR = dr;
-            }
+            min_dr2 = std::min(min_dr2, row[j]);
         }
     }
-    return min_dR;
+    return std::sqrt(min_dr2);
 }
 
 TLorentzVector MatchDijet(TLorentzVector const& hadW, std::vector<TLorentzVector> const& jets)
 {
-    size_t sz = jets.size();
-    std::vector<std::pair<int, int>> pairs;
-    pairs.reserve(sz*(sz-1)/2);
-    for (size_t i = 0; i < sz; ++i)
+    PairSearch search;
+    search.SetObjects(jets);
+    double mass = hadW.M();
+    auto MassDiff = [mass](Dijet const& d) { return std::abs(d.M() - mass); };
+    auto const& best = search.TopK(1, MassDiff, DijetCone(hadW.Eta(), hadW.Phi(), DR_THRESH));
+    if (!best.empty())
     {
-        for (size_t j = 0; j < sz; ++j)
-        {
-            pairs.emplace_back(i, j);
-        }
+        return jets[best[0].i] + jets[best[0].j];
     }
 
-    // double min_dm = 10e9;
-    // double min_dr = 6.0;
-    // TLorentzVector res{};
-    // for (auto const& p: pairs)
-    // {
-    //     auto [i1, i2] = p;
-    //     TLorentzVector dijet = jets[i1] + jets[i2];
-    //     double dr = hadW.DeltaR(dijet);
-
-    //     if (dr < DR_THRESH && dr < min_dr)
-    //     {
-    //         min_dr = dr;
-    //         double dm = std::abs(dijet.M() - hadW.M());
-    //         if (dm < min_dm)
-    //         {
-    //             res = dijet;
-    //         }
-    //     }
-    // }
-
-    // return res;
-
-    std::vector<TLorentzVector> close_dijets;
-    for (auto const& p: pairs)
-    {
-        auto [i1, i2] = p;
-        TLorentzVector dijet = jets[i1] + jets[i2];
-        double dr = hadW.DeltaR(dijet);
-
-        if (dr < DR_THRESH)
-        {
-            close_dijets.push_back(dijet);
-        }
-    }
-
-    // if (close_dijets.empty())
-    // {
-    //     return TLorentzVector{};
-    // }
-
-    // auto Cmp = [&hadW](TLorentzVector const& p1, TLorentzVector const& p2)
-    // {
-    //     return hadW.DeltaR(p1) < hadW.DeltaR(p2);
-    // };
-    // std::sort(close_dijets.begin(), close_dijets.end(), Cmp);
-    // return *close_dijets.begin();
-
+    // no dijet is close to hadW: fall back to jet with closest mass
     auto Comparator = [&hadW](TLorentzVector const& p1, TLorentzVector const& p2)
     { 
         return std::abs(p1.M() - hadW.M()) < std::abs(p2.M() - hadW.M()); 
     };
-
-    if (close_dijets.empty())
-    {
-        auto copy = jets;
-        std::sort(copy.begin(), copy.end(), Comparator);
-        return *copy.begin();
-    }
-
-    std::sort(close_dijets.begin(), close_dijets.end(), Comparator);
-    return *close_dijets.begin();
+    return *std::min_element(jets.begin(), jets.end(), Comparator);
 }
 
 
 bool IsIsolatedLepton(TLorentzVector const& lep, std::vector<TLorentzVector> const& jets)
 {
-    int count = jets.size();
-    for (auto const& j: jets)
-    {
-        if (j.DeltaR(lep) < DR_THRESH)
-        {
-            --count;
-        }
-    }
-    return count >= N_JETS_AWAY_FROM_LEP;
+    DeltaRMatrix dr;
+    dr.Fill(lep, jets);
+    return dr.NumCols() - dr.CountWithin(0, DR_THRESH) >= N_JETS_AWAY_FROM_LEP;
 }
 
 bool IsIsolatedLepton(TLorentzVector const& lep, KinematicData const& kd)
 {
-    auto const& [pt, eta, phi, m, n] = kd;
-    int count = n;
-    for (int j = 0; j < n; ++j)
-    {
-        TLorentzVector p = GetP4(kd, j);
-        if (p.DeltaR(lep) < DR_THRESH)
-        {
-            --count;
-        }
-    }
-    return count >= N_JETS_AWAY_FROM_LEP;
+    float lep_eta = lep.Eta();
+    float lep_phi = lep.Phi();
+    DeltaRMatrix dr;
+    dr.Fill(&lep_eta, &lep_phi, 1, kd.eta, kd.phi, kd.n);
+    return kd.n - dr.CountWithin(0, DR_THRESH) >= N_JETS_AWAY_FROM_LEP;
 }
 
 std::vector<int> PrimaryJetSelection(KinematicData const& kd)
@@ -504,11 +595,8 @@ std::vector<int> PrimaryJetSelection(KinematicData const& kd)
 
 double MinDeltaR(TLorentzVector const& v, std::vector<TLorentzVector> const& other)
 {
-    double res = 10.0;
-    for (auto const& p: other)
-    {
-        double dr = v.DeltaR(p);
-        res = std::min(dr, res);
-    }
-    return res;
+    DeltaRMatrix dr;
+    dr.Fill(v, other);
+    int idx = dr.ClosestCol(0);
+    return idx != -1 ? std::min(dr.DR(0, idx), 10.0) : 10.0;
 }
@@ -6,15 +6,20 @@
 #include <algorithm>
 #include <numeric>
 #include <memory>
+#include <cstdint>
 
 #include "TLorentzVector.h"
 #include "TH2.h"
 #include "TGraph.h"
 
+#include "PairSearch.hpp"
+
 // signal does not include tau leptons and neutrinos
 static const std::vector<int> SIG_LIGHT_QUARKS = {1, 2, 3, 4};
 static const std::vector<int> SIG_LEPTONS = {11, 13};
 static const std::vector<int> SIG_NEUTRINOS = {12, 14};
+// quarks W->qq decays to in signal pattern, b is allowed as in W->cb
+static const std::vector<int> SIG_QUARKS = {1, 2, 3, 4, 5};
 
 static const std::vector<int> LEPTONS = {11, 13, 15};
 static const std::vector<int> NEUTRINOS = {12, 14, 16};
@@ -48,6 +53,123 @@ enum SIG { X, H_bb, H_WW, b, bbar, LepWfirst, HadWfirst, HadWlast, q1, q2, LepWl
 
 void Print(TLorentzVector const& p, bool EXYZ = false);
 
+// decay graph of gen particles of one event, built once in O(n) from mother indices
+// children of every particle are stored contiguously (CSR) in increasing index order
+// particles are numbered in depth-first preorder, so descendants of a particle form a contiguous range of positions
+// and stable particles (without daughters) descending from it form a contiguous range of stable list
+// particles with mother index -1 or out of range are roots
+// buffers are reused when graph is rebuilt for the next event
+class GenParticleGraph
+{
+    public:
+    // view of contiguous indices, e.g. children of a particle
+    struct Range
+    {
+        int const* first = nullptr;
+        int const* last = nullptr;
+
+        inline int const* begin() const { return first; }
+        inline int const* end() const { return last; }
+        inline size_t size() const { return last - first; }
+        inline bool empty() const { return first == last; }
+    };
+
+    GenParticleGraph() = default;
+    GenParticleGraph(int const* mothers, int n_gen_part) { Build(mothers, n_gen_part); }
+
+    void Build(int const* mothers, int n_gen_part);
+
+    inline int Size() const { return m_n; }
+    inline bool IsValid(int idx) const { return idx >= 0 && idx < m_n; }
+    inline int Mother(int idx) const { return m_mothers[idx]; }
+    inline Range Children(int idx) const { return { m_children.data() + m_child_begin[idx], m_children.data() + m_child_begin[idx + 1] }; }
+    inline bool IsStable(int idx) const { return m_child_begin[idx] == m_child_begin[idx + 1]; }
+    // number of ancestors, 0 for roots
+    inline int Depth(int idx) const { return m_depth[idx]; }
+
+    // true if cand_idx is a (not necessarily immediate) daughter of parent_idx, O(1)
+    inline bool IsDescOf(int cand_idx, int parent_idx) const
+    {
+        if (!IsValid(cand_idx) || !IsValid(parent_idx))
+        {
+            return false;
+        }
+        return m_pos[parent_idx] < m_pos[cand_idx] && m_pos[cand_idx] < m_end[parent_idx];
+    }
+
+    // stable descendants of idx in preorder
+    inline Range StableDescendants(int idx) const
+    {
+        return { m_stable.data() + m_stable_count[m_pos[idx] + 1], m_stable.data() + m_stable_count[m_end[idx]] };
+    }
+
+    private:
+    int m_n = 0;
+    std::vector<int> m_mothers;
+    // children of i are m_children[m_child_begin[i]] ... m_children[m_child_begin[i + 1] - 1]
+    std::vector<int> m_child_begin;
+    std::vector<int> m_children;
+    std::vector<int> m_depth;
+    // preorder position of i and one past position of its last descendant
+    std::vector<int> m_pos;
+    std::vector<int> m_end;
+    // stable particles in preorder and number of stable particles before every preorder position
+    std::vector<int> m_stable;
+    std::vector<int> m_stable_count;
+    std::vector<int> m_stack;
+};
+
+// node of decay topology: particle with one of pdg ids (compared by absolute value if abs_id)
+// if the node has children or last_slot, particle is followed through its copies (daughter with the same pdg id) to the copy that decays
+// first_slot and last_slot receive indices of the matched particle and of its decaying copy, -1 means not recorded
+// every child must match a distinct daughter of the decaying copy; if exact, there must be no other daughters
+// daughters of nodes without children (e.g. showering quarks) are not constrained
+struct DecayNode
+{
+    std::vector<int> ids;
+    bool abs_id = false;
+    int first_slot = -1;
+    int last_slot = -1;
+    bool exact = true;
+    std::vector<DecayNode> children;
+};
+
+// decay topology compiled to flat array of nodes, children of every node are contiguous
+// matching is one pass over gen record looking for root candidates (from the last particle backwards)
+// and a walk down the decay graph for every candidate with backtracking over assignments of daughters to children
+class DecayPattern
+{
+    public:
+    DecayPattern(DecayNode const& root, int n_slots);
+
+    // slot indices of the first matching candidate, empty vector if none matches
+    std::vector<int> Match(int const* pdg_ids, GenParticleGraph const& graph) const;
+
+    private:
+    struct Node
+    {
+        std::vector<int> ids;
+        bool abs_id;
+        int first_slot;
+        int last_slot;
+        bool exact;
+        int first_child;
+        int n_children;
+    };
+
+    void Compile(DecayNode const& node, int pos);
+    bool HasId(Node const& node, int pdg_id) const;
+    bool MatchNode(int node_idx, int part_idx, int const* pdg_ids, GenParticleGraph const& graph, std::vector<int>& slots) const;
+    bool MatchChildren(Node const& node, int child, GenParticleGraph::Range daughters, std::uint64_t used,
+                       int const* pdg_ids, GenParticleGraph const& graph, std::vector<int>& slots) const;
+
+    std::vector<Node> m_nodes;
+    int m_n_slots;
+};
+
+// X->HH, H->bb, H->WW->lvqq, slots are SIG
+DecayPattern const& SignalPatternSL();
+
 // finds closest daughters of particle at location part_idx in the event;
 // returns indices of what found
 std::vector<int> GetNextGeneration(int part_idx, int const* mothers, int n_gen_part);
@@ -55,12 +177,14 @@ std::vector<int> GetNextGeneration(int part_idx, int const* mothers, int n_gen_p
 // finds all descendants of particle at location part_idx in the event;
 // descendants are grouped into generations (inner vectors): generation 0 is particle itself, generation 1 are its immediate daughters, etc ...
 std::vector<std::vector<int>> GetDescendants(int part_idx, int const* mothers, int n_gen_part);
+std::vector<std::vector<int>> GetDescendants(int part_idx, GenParticleGraph const& graph);
 
 // finds all particles by index that do not have daughters
 std::vector<int> GetFinalParticles(int const* mothers, int n_gen_part);
 
 // finds stable descendants (that don't have any daughters) of particle at part_idx
 std::vector<int> GetStableDescendants(int part_idx, int const* mothers, int n_gen_part);
+std::vector<int> GetStableDescendants(int part_idx, GenParticleGraph const& graph);
 
 // by default onlyh prints pdg_id(mother_idx) (in that format)
 // if print_idx is true, prints pdg_id[idx](mother_idx)
@@ -74,9 +198,11 @@ int FindLast(int target_id, int const* pdg_ids, int n_gen_part);
 // head is position of the last heavy higgs, i.e. index where the decay starts 
 // if any signal particle was not found returns empty vector
 std::vector<int> GetSignal(int const* pdg_ids, int const* mothers, int n_gen_part);
+std::vector<int> GetSignal(int const* pdg_ids, GenParticleGraph const& graph);
 
 // finds daughters with pdg ids in range desc_range of mother at mother_idx 
 std::vector<int> FindSpecificDescendants(std::vector<int> const& desc_range, int mother_idx, int const* mothers, int const* pdg_ids, int n_gen_part);
+std::vector<int> FindSpecificDescendants(std::vector<int> const& desc_range, int mother_idx, GenParticleGraph const& graph, int const* pdg_ids);
 
 // self-explanatory helper functions
 inline bool IsSigLightQuark(int pdg_id) { return std::find(SIG_LIGHT_QUARKS.begin(), SIG_LIGHT_QUARKS.end(), std::abs(pdg_id)) != SIG_LIGHT_QUARKS.end(); }
@@ -88,9 +214,11 @@ inline bool IsLep(int pdg_id) { return std::find(LEPTONS.begin(), LEPTONS.end(),
 
 // check validity of signal particles
 bool HasOnlyEleMu(std::vector<int> const& signal, int const* mothers, int const* pdg_ids);
+bool HasOnlyEleMu(std::vector<int> const& signal, GenParticleGraph const& graph, int const* pdg_ids);
 
 // checks of particle cand_idx is daughter of particle parent_idx
 bool IsDescOf(int cand_idx, int parent_idx, int const* mothers);
+inline bool IsDescOf(int cand_idx, int parent_idx, GenParticleGraph const& graph) { return graph.IsDescOf(cand_idx, parent_idx); }
 
 struct KinematicData
 {
@@ -155,45 +283,6 @@ inline bool PassLeptonCut(TLorentzVector const& lep)
     return lep.Pt() > MIN_LEP_PT && std::abs(lep.Eta()) < MAX_LEP_ETA;
 }
 
-template <typename Func>
-std::pair<int, int> ChooseBestPair(std::vector<TLorentzVector> const& jets, Func func)
-{
-    size_t sz = jets.size();
-    if (sz == 2)
-    {
-        return {0, 1};
-    }
-
-
-    std::vector<std::pair<int, int>> pairs;
-    pairs.reserve(sz*(sz-1)/2);
-    for (size_t i = 0; i < sz; ++i)
-    {
-        for (size_t j = 0; j < sz; ++j)
-        {
-            pairs.emplace_back(i, j);
-        }
-    }
-
-    double min_metric = 10e9;
-    std::pair<int, int> res{-1, -1};
-    for (auto const& p: pairs)
-    {
-        auto [i1, i2] = p;
-        TLorentzVector const& jet1 = jets[i1];
-        TLorentzVector const& jet2 = jets[i2];
-
-        double metric = func(jet1, jet2);
-        if (metric < min_metric)
-        {
-            min_metric = metric;
-            res = p;
-        }
-    }
-
-    return res;
-}
-
 template <typename Func>
 std::pair<double, double> CalcJetPairStats(std::vector<TLorentzVector> const& jets, Func func)
 {
@@ -0,0 +1,131 @@
+#include <iostream>
+#include <vector>
+#include <array>
+#include <memory>
+#include <chrono>
+#include <stdexcept>
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TString.h"
+#include "TROOT.h"
+
+#include "Constants.hpp"
+#include "GenBranch.hpp"
+#include "JetAssignment.hpp"
+#include "MatchTree.hpp"
+
+// matching pass: gen quarks of every event of flat ntuples are matched to reco jets (centralJet) once
+// and written to a friend tree next to the input file (see MatchTree.hpp)
+// analyzer and PDF builders read the friend tree instead of matching on the fly
+// usage: match_tree <sl|dl> <input.root> [<input.root> ...]
+
+void WriteMatches(TString const& input_name, Channel ch)
+{
+    std::unique_ptr<TFile> input(TFile::Open(input_name));
+    if (!input || input->IsZombie())
+    {
+        throw std::runtime_error("Unable to open file " + std::string(input_name.Data()));
+    }
+
+    TTree* tree = input->Get<TTree>("Events");
+    if (!tree)
+    {
+        throw std::runtime_error("No tree Events in file " + std::string(input_name.Data()));
+    }
+
+    // only branches used by matching are read
+    std::vector<TString> quark_prefixes = {"genb1", "genb2"};
+    if (ch == Channel::SL)
+    {
+        quark_prefixes.push_back("genV2prod1");
+        quark_prefixes.push_back("genV2prod2");
+    }
+    tree->SetBranchStatus("*", false);
+    for (char const* name: {"event", "ncentralJet", "centralJet_eta", "centralJet_phi"})
+    {
+        tree->SetBranchStatus(name, true);
+    }
+    for (auto const& prefix: quark_prefixes)
+    {
+        tree->SetBranchStatus(prefix + "_eta", true);
+        tree->SetBranchStatus(prefix + "_phi", true);
+    }
+
+    ULong64_t event = 0;
+    Int_t n_jets = 0;
+    Float_t jet_eta[MAX_RECO_JET];
+    Float_t jet_phi[MAX_RECO_JET];
+    tree->SetBranchAddress("event", &event);
+    tree->SetBranchAddress("ncentralJet", &n_jets);
+    tree->SetBranchAddress("centralJet_eta", jet_eta);
+    tree->SetBranchAddress("centralJet_phi", jet_phi);
+
+    int n_quarks = quark_prefixes.size();
+    std::vector<GenBranch> quark_eta(n_quarks);
+    std::vector<GenBranch> quark_phi(n_quarks);
+    for (int q = 0; q < n_quarks; ++q)
+    {
+        quark_eta[q].Connect(tree, quark_prefixes[q] + "_eta");
+        quark_phi[q].Connect(tree, quark_prefixes[q] + "_phi");
+    }
+
+    TString output_name = MatchFileName(input_name, ch);
+    std::unique_ptr<TFile> output(TFile::Open(output_name, "RECREATE"));
+    if (!output || output->IsZombie())
+    {
+        throw std::runtime_error("Unable to create file " + std::string(output_name.Data()));
+    }
+
+    // owned by output file
+    TTree* match_tree = new TTree(MATCH_TREE_NAME, "gen quark to reco jet matching");
+    MatchRecord record;
+    record.Branch(match_tree);
+
+    std::array<Float_t, MAX_GEN_QUARK> eta;
+    std::array<Float_t, MAX_GEN_QUARK> phi;
+    DeltaRMatrix dr;
+    AssignmentSolver solver;
+    Long64_t n_complete = 0;
+    Long64_t n_events = tree->GetEntries();
+    for (Long64_t i = 0; i < n_events; ++i)
+    {
+        tree->GetEntry(i);
+        for (int q = 0; q < n_quarks; ++q)
+        {
+            eta[q] = quark_eta[q].Get();
+            phi[q] = quark_phi[q].Get();
+        }
+
+        dr.Fill(eta.data(), phi.data(), n_quarks, jet_eta, jet_phi, n_jets);
+        record.Set(event, solver.Solve(dr), dr);
+        n_complete += record.IsComplete();
+        match_tree->Fill();
+    }
+
+    output->Write();
+    output->Close();
+    std::cout << input_name << " -> " << output_name << ": " << n_complete << "/" << n_events << " events with all quarks matched\n";
+}
+
+int main(int argc, char* argv[])
+{
+    gROOT->ProcessLine("gErrorIgnoreLevel = 6001;");
+
+    if (argc < 3 || (TString(argv[1]) != "sl" && TString(argv[1]) != "dl"))
+    {
+        std::cerr << "usage: match_tree <sl|dl> <input.root> [<input.root> ...]\n";
+        return 1;
+    }
+
+    Channel ch = TString(argv[1]) == "sl" ? Channel::SL : Channel::DL;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 2; i < argc; ++i)
+    {
+        WriteMatches(argv[i], ch);
+    }
+    auto finish = std::chrono::steady_clock::now();
+    std::cout << "done in " << std::chrono::duration<double>(finish - start).count() << " s\n";
+    return 0;
+}
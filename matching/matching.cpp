@@ -18,6 +18,7 @@
 
 #include "MatchingTools.hpp"
 #include "HistManager.hpp"
+#include "JetAssignment.hpp"
 
 static constexpr int MAX_AK4_GENJET = 21;
 static constexpr int MAX_AK8_GENJET = 7;
@@ -100,43 +101,43 @@ int main()
     HistManager hm;
 
     std::string hadW_mass_strategy_1("hadW_mass_strategy_1");
-    hm.Add(hadW_mass_strategy_1, "Mass of HadW from jets chosen by minimizing metric", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_mass_strategy_1_h = hm.Add(hadW_mass_strategy_1, "Mass of HadW from jets chosen by minimizing metric", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_mass_matched_dijet("hadW_mass_matched_dijet");
-    hm.Add(hadW_mass_matched_dijet, "Mass of HadW from matching dijets to HadW", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_mass_matched_dijet_h = hm.Add(hadW_mass_matched_dijet, "Mass of HadW from matching dijets to HadW", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_mass_gen("hadW_mass_gen");
-    hm.Add(hadW_mass_gen, "Gen mass of HadW", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_mass_gen_h = hm.Add(hadW_mass_gen, "Gen mass of HadW", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_best_offshell_mass("hadW_best_offshell_mass");
-    hm.Add(hadW_best_offshell_mass, "Best offshell HadW mass", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_best_offshell_mass_h = hm.Add(hadW_best_offshell_mass, "Best offshell HadW mass", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_best_onshell_mass("hadW_best_onshell_mass");
-    hm.Add(hadW_best_onshell_mass, "Best onshell HadW mass", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_best_onshell_mass_h = hm.Add(hadW_best_onshell_mass, "Best onshell HadW mass", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_mass_strategy_1_all("hadW_mass_strategy_1_all");
-    hm.Add(hadW_mass_strategy_1_all, "Mass of HadW from jets chosen by minimizing metric for all accepted events", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_mass_strategy_1_all_h = hm.Add(hadW_mass_strategy_1_all, "Mass of HadW from jets chosen by minimizing metric for all accepted events", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_mass_strategy_2_all("hadW_mass_strategy_2_all");
-    hm.Add(hadW_mass_strategy_2_all, "Mass of HadW when choosing best onshell and offshell pairs separately", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_mass_strategy_2_all_h = hm.Add(hadW_mass_strategy_2_all, "Mass of HadW when choosing best onshell and offshell pairs separately", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_mass_strategy_2("hadW_mass_strategy_2");
-    hm.Add(hadW_mass_strategy_2, "Mass of HadW from jets chosen by selecting best offshel and onshell pairs separately and choosing best", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_mass_strategy_2_h = hm.Add(hadW_mass_strategy_2, "Mass of HadW from jets chosen by selecting best offshel and onshell pairs separately and choosing best", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_mass_matched_single("hadW_mass_matched_single");
-    hm.Add(hadW_mass_matched_single, "Mass of HadW from jets chosen by mathcing jets to quarks", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_mass_matched_single_h = hm.Add(hadW_mass_matched_single, "Mass of HadW from jets chosen by mathcing jets to quarks", {"HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_offshell_matched("hadW_offshell_matched");
-    hm.Add(hadW_offshell_matched, "Visible mass of offshell HadW", {"offshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_offshell_matched_h = hm.Add(hadW_offshell_matched, "Visible mass of offshell HadW", {"offshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_onshell_matched("hadW_onshell_matched");
-    hm.Add(hadW_onshell_matched, "Visible mass of onshell HadW", {"onshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_onshell_matched_h = hm.Add(hadW_onshell_matched, "Visible mass of onshell HadW", {"onshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_offshell_gen("hadW_offshell_gen");
-    hm.Add(hadW_offshell_gen, "Gen mass of offshell HadW", {"offshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_offshell_gen_h = hm.Add(hadW_offshell_gen, "Gen mass of offshell HadW", {"offshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string hadW_onshell_gen("hadW_onshell_gen");
-    hm.Add(hadW_onshell_gen, "Gen mass of onshell HadW", {"onshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
+    auto hadW_onshell_gen_h = hm.Add(hadW_onshell_gen, "Gen mass of onshell HadW", {"onshell HadW mass, [GeV]", "Count"}, {0, 200}, 100);
 
     // std::string pdf_hadW_offshell("pdf_hadW_offshell");
     // hm.Add(pdf_hadW_offshell, "PDF for visible mass of offshell HadW", {"offshell HadW mass, [GeV]", "Count"}, {0, 300}, 300);
@@ -148,7 +149,7 @@ int main()
     // hm.Add(hadW_mass_choose, "Mass of HadW from jets chosen by minimizing angle between them and |m(jj) - mW|", {"HadW mass, [GeV]", "Count"}, {0, 300}, 100);
 
     std::string number_of_matches("number_of_matches");
-    hm.Add(number_of_matches, "Number of jets matched  to q1 and q2", {"N", "Count"}, {-0.5, 6.5}, 7);
+    auto number_of_matches_h = hm.Add(number_of_matches, "Number of jets matched  to q1 and q2", {"N", "Count"}, {-0.5, 6.5}, 7);
 
     // std::string q1_pt_vs_q2_pt_q1_match("q1_pt_vs_q2_pt_q1_match");
     // hm.Add(q1_pt_vs_q2_pt_q1_match, "q1 pt vs q2 pt when q1 has match", {"q1 pt, [GeV]", "q2 pt, [GeV]"}, {0, 200}, {0, 200}, {100, 100});
@@ -157,28 +158,32 @@ int main()
     // hm.Add(q1_pt_vs_q2_pt_q2_match, "q1 pt vs q2 pt when q2 has match", {"q1 pt, [GeV]", "q2 pt, [GeV]"}, {0, 200}, {0, 200}, {100, 100});
 
     std::string pt_of_quark_wo_match("pt_of_quark_wo_match");
-    hm.Add(pt_of_quark_wo_match, "Pt of quark which doesn't have match within dR < 0.4", {"Pt, [GeV]", "Count"}, {0, 200}, 100);
+    auto pt_of_quark_wo_match_h = hm.Add(pt_of_quark_wo_match, "Pt of quark which doesn't have match within dR < 0.4", {"Pt, [GeV]", "Count"}, {0, 200}, 100);
 
     std::string min_dr_of_quark_wo_match("min_dr_of_quark_wo_match");
-    hm.Add(min_dr_of_quark_wo_match, "Min dR between quark without match and selected jets", {"dR", "Count"}, {0, 6}, 100);
+    auto min_dr_of_quark_wo_match_h = hm.Add(min_dr_of_quark_wo_match, "Min dR between quark without match and selected jets", {"dR", "Count"}, {0, 6}, 100);
 
     std::string best_offshell_mass_vs_best_onshell_mass("best_offshell_mass_vs_best_onshell_mass");
-    hm.Add(best_offshell_mass_vs_best_onshell_mass, "Best mass of offshell pair vs best mass of onshell pair", {"Offshell mass, [GeV]", "Onshell mass, [GeV]"}, {0, 200}, {0, 200}, {100, 100});
+    auto best_offshell_mass_vs_best_onshell_mass_h = hm.Add(best_offshell_mass_vs_best_onshell_mass, "Best mass of offshell pair vs best mass of onshell pair", {"Offshell mass, [GeV]", "Onshell mass, [GeV]"}, {0, 200}, {0, 200}, {100, 100});
 
     std::string number_of_light_jets("number_of_light_jets");
-    hm.Add(number_of_light_jets, "Number of selected light jets", {"N", "Count"}, {-0.5, 10.5}, 11);
+    auto number_of_light_jets_h = hm.Add(number_of_light_jets, "Number of selected light jets", {"N", "Count"}, {-0.5, 10.5}, 11);
 
     std::cout << std::boolalpha;
 
+    GenParticleGraph gen_graph;
+    DeltaRMatrix lep_jet_dr;
+    PairSearch pair_search;
     for (int i = 0; i < nEvents; ++i)
     {
         myTree->GetEntry(i);
         
-        auto sig  = GetSignal(GenPart_pdgId, GenPart_genPartIdxMother, nGenPart);
+        gen_graph.Build(GenPart_genPartIdxMother, nGenPart);
+        auto sig  = GetSignal(GenPart_pdgId, gen_graph);
 
         if (!sig.empty())
         {
-            if (HasOnlyEleMu(sig, GenPart_genPartIdxMother, GenPart_pdgId)) 
+            if (HasOnlyEleMu(sig, gen_graph, GenPart_pdgId)) 
             {
                 ++tot;
                 if (std::abs(GenPart_pdgId[sig[SIG::q1]]) == 5 || std::abs(GenPart_pdgId[sig[SIG::q2]]) == 5)
@@ -233,10 +238,11 @@ int main()
                 }
 
                 // perform jet cleaning: reject jets overlapping with the lepton
-                auto JetLepOverlap = [&l_p4, &genjet_ak4](int i)
+                int l_idx = sig[SIG::l];
+                lep_jet_dr.Fill(genpart.eta + l_idx, genpart.phi + l_idx, 1, genjet_ak4.eta, genjet_ak4.phi, genjet_ak4.n);
+                auto JetLepOverlap = [&lep_jet_dr](int i)
                 { 
-                    TLorentzVector p = GetP4(genjet_ak4, i);
-                    return p.DeltaR(l_p4) < DR_THRESH;
+                    return lep_jet_dr.DR2(0, i) < DR_THRESH*DR_THRESH;
                 };
                 selected_jets.erase(std::remove_if(selected_jets.begin(), selected_jets.end(), JetLepOverlap), selected_jets.end());
                 if (selected_jets.size() < 4)
@@ -308,97 +314,80 @@ int main()
 
                 ++selected_events;
 
-                hm.Fill(number_of_light_jets, light_jets.size());
+                hm.Fill(number_of_light_jets_h, light_jets.size());
 
                 auto [mean_ang, std_ang] = CalcJetPairStats(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return p1.Angle(p2.Vect()); });
                 // auto [mean_dr, std_dr] = CalcJetPairStats(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return p1.DeltaR(p2); });
                 auto [mean_dm, std_dm] = CalcJetPairStats(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return 80.0 - (p1 + p2).M(); });
                 // auto [mean_pt, std_pt] = CalcJetPairStats(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return (p1 + p2).Pt(); });
 
-                // auto metric = [&mean_dr, &std_dr, &mean_dm, &std_dm](TLorentzVector const& p1, TLorentzVector const& p2)
-                auto metric = [&mean_ang, &std_ang, &mean_dm, &std_dm](TLorentzVector const& p1, TLorentzVector const& p2)
+                // best pair by metric among pairs giving lepton + dijet mass below Higgs mass, otherwise best pair overall
+                // metric and selection use 4-momenta cached by pair_search, no TLorentzVector is built per pair
+                pair_search.SetObjects(light_jets);
+                auto metric = [&pair_search, &mean_ang, &std_ang, &mean_dm, &std_dm](Dijet const& d)
                 {
-                    double ang = p1.Angle(p2.Vect()); 
+                    double ang = pair_search.Angle(d.i, d.j);
                     double z_ang = (ang - mean_ang)/std_ang;
-                    
-                    // double dr = p1.DeltaR(p2);
-                    // double z_dr = (dr - mean_dr)/std_dr;
 
-                    double dm = 80.0 - (p1 + p2).M();
+                    double dm = 80.0 - d.M();
                     double z_dm = (dm - mean_dm)/std_dm;
 
-                    // double pt = (p1 + p2).Pt();
-                    // double z_pt = (pt - mean_pt)/std_pt;
-
                     return z_ang*z_ang + z_dm*z_dm;
-                    // return z_dr*z_dr + z_dm*z_dm;
                 };
-
-                std::vector<std::pair<int, int>> pairs;
-                for (size_t i = 0; i < light_jets.size(); ++i)
-                {
-                    for (size_t j = i + 1; j < light_jets.size(); ++j)
-                    {
-                        pairs.emplace_back(i, j);
-                    }
-                }
-
-                auto JetComparator = [&metric, &light_jets](std::pair<int, int> const& p1, std::pair<int, int> const& p2)
+                auto BelowHiggsMass = [&l_p4](Dijet d)
                 {
-                    return metric(light_jets[p1.first], light_jets[p1.second]) < metric(light_jets[p2.first], light_jets[p2.second]);
+                    d.px += l_p4.Px();
+                    d.py += l_p4.Py();
+                    d.pz += l_p4.Pz();
+                    d.e += l_p4.E();
+                    return d.M() < 125.0;
                 };
-                std::sort(pairs.begin(), pairs.end(), JetComparator);
-
                 std::pair<int, int> bp{-1, -1};
-                for (auto const& p: pairs)
+                if (auto const& best = pair_search.TopK(1, metric, BelowHiggsMass); !best.empty())
                 {
-                    double mass = (l_p4 + light_jets[p.first] + light_jets[p.second]).M();
-                    if (mass < 125.0)
-                    {
-                        bp = p;
-                        break;
-                    }
+                    bp = {best[0].i, best[0].j};
                 }
-
-                if (bp.first == -1)
+                else if (auto const& best_any = pair_search.TopK(1, metric); !best_any.empty())
                 {
-                    bp = pairs[0];
+                    bp = {best_any[0].i, best_any[0].j};
                 }
                 
                 // auto [bi1, bi2] = ChooseBestPair(light_jets, metric);
                 auto [bi1, bi2] = bp;
                 double bp_mass = (light_jets[bi1] + light_jets[bi2]).M();
-                hm.Fill(hadW_mass_strategy_1_all, bp_mass);
+                hm.Fill(hadW_mass_strategy_1_all_h, bp_mass);
 
-                auto best_onshell_pair = ChooseBestPair(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return std::abs(80.0 - (p1 + p2).M()); });
-                auto best_offshell_pair = ChooseBestPair(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return std::abs(40.0 - (p1 + p2).M()); });
+                auto best_onshell_pair = ChooseBestPair(light_jets, [](Dijet const& d){ return std::abs(80.0 - d.M()); });
+                auto best_offshell_pair = ChooseBestPair(light_jets, [](Dijet const& d){ return std::abs(40.0 - d.M()); });
 
                 double best_onshell_mass = (light_jets[best_onshell_pair.first] + light_jets[best_onshell_pair.second]).M();
                 double best_offshell_mass = (light_jets[best_offshell_pair.first] + light_jets[best_offshell_pair.second]).M();
-                hm.Fill(hadW_mass_strategy_2_all, rg.Uniform(0, 1) > 0.27 ? best_onshell_mass : best_offshell_mass);
-                // hm.FillWeighted(hadW_mass_strategy_2_all, best_offshell_mass, 0.5);
-                // hm.FillWeighted(hadW_mass_strategy_2_all, best_onshell_mass, 0.5);
+                hm.Fill(hadW_mass_strategy_2_all_h, rg.Uniform(0, 1) > 0.27 ? best_onshell_mass : best_offshell_mass);
+                // hm.FillWeighted(hadW_mass_strategy_2_all_h, best_offshell_mass, 0.5);
+                // hm.FillWeighted(hadW_mass_strategy_2_all_h, best_onshell_mass, 0.5);
 
                 if (light_jets.size() > 2)
                 {
-                    hm.Fill(best_offshell_mass_vs_best_onshell_mass, best_offshell_mass, best_onshell_mass);
+                    hm.Fill(best_offshell_mass_vs_best_onshell_mass_h, best_offshell_mass, best_onshell_mass);
                 }
 
                 auto mq1 = Matches(sig[SIG::q1], genpart, genjet_ak4);
                 auto mq2 = Matches(sig[SIG::q2], genpart, genjet_ak4);
-                hm.Fill(number_of_matches, mq1.size() + mq2.size());
+                hm.Fill(number_of_matches_h, mq1.size() + mq2.size());
 
                 // int best_q1_match = Match(sig[SIG::q1], genpart, genjet_ak4);
                 // int best_q2_match = Match(sig[SIG::q2], genpart, genjet_ak4);
-                int best_q1_match = Match(q1_p4, light_jets);
-                int best_q2_match = Match(q2_p4, light_jets);
+                // quarks are matched to distinct jets, so both can not have the same best match
+                Assignment q_match = MatchPartons(std::vector<TLorentzVector>{q1_p4, q2_p4}, light_jets, DR_THRESH);
+                int best_q1_match = q_match.jets[0];
+                int best_q2_match = q_match.jets[1];
 
                 TLorentzVector hadW = GetP4(genpart, sig[SIG::HadWlast]);
                 TLorentzVector matched_dijet = MatchDijet(hadW, light_jets);
-                hm.Fill(hadW_mass_matched_dijet, matched_dijet.M());
+                hm.Fill(hadW_mass_matched_dijet_h, matched_dijet.M());
                 // if (matched_dijet.Pt() > 0.0)
                 // {
-                //     hm.Fill(hadW_mass_matched_dijet, matched_dijet.M());
+                //     hm.Fill(hadW_mass_matched_dijet_h, matched_dijet.M());
                 // }
                 // else 
                 // {
@@ -409,23 +398,23 @@ int main()
                 {
                     ++only_q1_match;
                     // hm.Fill(q1_pt_vs_q2_pt_q1_match, q1_p4.Pt(), q2_p4.Pt());
-                    hm.Fill(pt_of_quark_wo_match, q2_p4.Pt());
-                    hm.Fill(min_dr_of_quark_wo_match, MinDeltaR(q2_p4, light_jets));
+                    hm.Fill(pt_of_quark_wo_match_h, q2_p4.Pt());
+                    hm.Fill(min_dr_of_quark_wo_match_h, MinDeltaR(q2_p4, light_jets));
 
                     // find second match by mass
                     int second_match = FindSecondMatch(best_q1_match, hadW, light_jets);
-                    hm.Fill(hadW_mass_matched_single, (light_jets[best_q1_match] + light_jets[second_match]).M());
+                    hm.Fill(hadW_mass_matched_single_h, (light_jets[best_q1_match] + light_jets[second_match]).M());
                 }
 
                 if (best_q1_match == -1 && best_q2_match != -1)
                 {
                     ++only_q2_match;
                     // hm.Fill(q1_pt_vs_q2_pt_q2_match, q1_p4.Pt(), q2_p4.Pt());
-                    hm.Fill(pt_of_quark_wo_match, q1_p4.Pt());
-                    hm.Fill(min_dr_of_quark_wo_match, MinDeltaR(q1_p4, light_jets));
+                    hm.Fill(pt_of_quark_wo_match_h, q1_p4.Pt());
+                    hm.Fill(min_dr_of_quark_wo_match_h, MinDeltaR(q1_p4, light_jets));
 
                     int second_match = FindSecondMatch(best_q2_match, hadW, light_jets);
-                    hm.Fill(hadW_mass_matched_single, (light_jets[best_q2_match] + light_jets[second_match]).M());
+                    hm.Fill(hadW_mass_matched_single_h, (light_jets[best_q2_match] + light_jets[second_match]).M());
                 }
 
                 if (best_q1_match != -1 && best_q2_match != -1)
@@ -434,7 +423,7 @@ int main()
                     if (best_q1_match == best_q2_match)
                     {
                         ++same_best_match;
-                        hm.Fill(hadW_mass_matched_single, light_jets[best_q1_match].M());
+                        hm.Fill(hadW_mass_matched_single_h, light_jets[best_q1_match].M());
                     }
                     else 
                     {
@@ -443,93 +432,54 @@ int main()
                         TLorentzVector j1_p4 = light_jets[best_q1_match];
                         TLorentzVector j2_p4 = light_jets[best_q2_match];
                         double hadW_mass = (j1_p4 + j2_p4).M();
-                        hm.Fill(hadW_mass_matched_single, hadW_mass);
+                        hm.Fill(hadW_mass_matched_single_h, hadW_mass);
 
                         double hadW_gen = GenPart_mass[sig[SIG::HadWlast]];
                         double lepW_gen = GenPart_mass[sig[SIG::LepWlast]];
                         if (hadW_gen > lepW_gen)
                         {
-                            hm.Fill(hadW_onshell_matched, hadW_mass);
-                            hm.Fill(hadW_onshell_gen, hadW_gen);
+                            hm.Fill(hadW_onshell_matched_h, hadW_mass);
+                            hm.Fill(hadW_onshell_gen_h, hadW_gen);
                             // hm.Fill(pdf_hadW_onshell, hadW_mass);
                         }
                         else
                         {
-                            hm.Fill(hadW_offshell_matched, hadW_mass);
-                            hm.Fill(hadW_offshell_gen, hadW_gen);
+                            hm.Fill(hadW_offshell_matched_h, hadW_mass);
+                            hm.Fill(hadW_offshell_gen_h, hadW_gen);
                             // hm.Fill(pdf_hadW_offshell, hadW_mass);
                         }
-                        hm.Fill(hadW_mass_gen, hadW_gen);
-
-                        auto [mean_ang, std_ang] = CalcJetPairStats(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return p1.Angle(p2.Vect()); });
-                        auto [mean_dm, std_dm] = CalcJetPairStats(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return 80.0 - (p1 + p2).M(); });
-                        // auto [mean_pt, std_pt] = CalcJetPairStats(light_jets, [](TLorentzVector const& p1, TLorentzVector const& p2){ return (p1 + p2).Pt(); });
+                        hm.Fill(hadW_mass_gen_h, hadW_gen);
 
-                        auto metric = [&mean_ang, &std_ang, &mean_dm, &std_dm](TLorentzVector const& p1, TLorentzVector const& p2)
-                        {
-                            double ang = p1.Angle(p2.Vect()); 
-                            double z_ang = (ang - mean_ang)/std_ang;
-
-                            double dm = 80.0 - (p1 + p2).M();
-                            double z_dm = (dm - mean_dm)/std_dm;
-
-                            // double pt = (p1 + p2).Pt();
-                            // double z_pt = (pt - mean_pt)/std_pt;
-
-                            return z_ang*z_ang + z_dm*z_dm;
-                        };
-
-                        std::vector<std::pair<int, int>> pairs;
-                        for (size_t i = 0; i < light_jets.size(); ++i)
-                        {
-                            for (size_t j = i + 1; j < light_jets.size(); ++j)
-                            {
-                                pairs.emplace_back(i, j);
-                            }
-                        }
-
-                        auto JetComparator = [&metric, &light_jets](std::pair<int, int> const& p1, std::pair<int, int> const& p2)
-                        {
-                            return metric(light_jets[p1.first], light_jets[p1.second]) < metric(light_jets[p2.first], light_jets[p2.second]);
-                        };
-                        std::sort(pairs.begin(), pairs.end(), JetComparator);
-
-                        // std::pair<int, int> bp{-1, -1};
+                        // same light jets as above: pair_search still caches them, so metric and selection are reused
                         bp = std::pair<int, int>(-1, -1);
-                        for (auto const& p: pairs)
+                        if (auto const& best = pair_search.TopK(1, metric, BelowHiggsMass); !best.empty())
                         {
-                            double mass = (l_p4 + light_jets[p.first] + light_jets[p.second]).M();
-                            if (mass < 125.0)
-                            {
-                                bp = p;
-                                break;
-                            }
+                            bp = {best[0].i, best[0].j};
                         }
-
-                        if (bp.first == -1)
+                        else if (auto const& best_any = pair_search.TopK(1, metric); !best_any.empty())
                         {
-                            bp = pairs[0];
+                            bp = {best_any[0].i, best_any[0].j};
                         }
 
                         auto [bi1, bi2] = bp;
                         double bp_mass = (light_jets[bi1] + light_jets[bi2]).M();
-                        hm.Fill(hadW_mass_strategy_1, bp_mass);
+                        hm.Fill(hadW_mass_strategy_1_h, bp_mass);
 
                         best_onshell_mass = (light_jets[best_onshell_pair.first] + light_jets[best_onshell_pair.second]).M();
                         // double onshell_weight = pdf_hadW_onshell->GetBinContent(pdf_hadW_onshell->FindBin(best_onshell_mass));
-                        hm.Fill(hadW_best_onshell_mass, best_onshell_mass);
+                        hm.Fill(hadW_best_onshell_mass_h, best_onshell_mass);
 
                         best_offshell_mass = (light_jets[best_offshell_pair.first] + light_jets[best_offshell_pair.second]).M();
                         // double offshell_weight = pdf_hadW_offshell->GetBinContent(pdf_hadW_offshell->FindBin(best_offshell_mass));
-                        hm.Fill(hadW_best_offshell_mass, best_offshell_mass);
+                        hm.Fill(hadW_best_offshell_mass_h, best_offshell_mass);
 
-                        // hm.Fill(best_offshell_mass_vs_best_onshell_mass, best_offshell_mass, best_onshell_mass);
+                        // hm.Fill(best_offshell_mass_vs_best_onshell_mass_h, best_offshell_mass, best_onshell_mass);
 
                         // double best_mass = onshell_weight > offshell_weight ? best_onshell_mass : best_offshell_mass;
                         double best_mass = rg.Uniform(0, 1) > 0.27 ? best_onshell_mass : best_offshell_mass;
-                        hm.Fill(hadW_mass_strategy_2, best_mass);
-                        // hm.FillWeighted(hadW_mass_strategy_2, best_offshell_mass, 0.5);
-                        // hm.FillWeighted(hadW_mass_strategy_2, best_onshell_mass, 0.5);
+                        hm.Fill(hadW_mass_strategy_2_h, best_mass);
+                        // hm.FillWeighted(hadW_mass_strategy_2_h, best_offshell_mass, 0.5);
+                        // hm.FillWeighted(hadW_mass_strategy_2_h, best_onshell_mass, 0.5);
                     }
                 }
             }    
@@ -0,0 +1,89 @@
+#ifndef BOOTSTRAP_HPP
+#define BOOTSTRAP_HPP
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include "TString.h"
+
+// number of Poisson(1) CDF thresholds, P(w > 12) is below resolution of 32-bit uniform numbers
+inline constexpr int N_POISSON_THRESHOLDS = 12;
+
+// splitmix64 finalizer
+inline std::uint64_t Mix64(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// FNV-1a, stable across platforms and runs unlike std::hash
+inline std::uint64_t HashName(TString const& name)
+{
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char const* c = name.Data(); *c; ++c)
+    {
+        hash ^= static_cast<unsigned char>(*c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// weights of bootstrap replicas: every replica sees every event Poisson(1) times
+// counter-based: weight of replica k for entry of a file depends only on seed, file name, entry and k,
+// so replicas do not depend on number of threads, order of processing or which partials were rebuilt
+class PoissonWeights
+{
+    public:
+    PoissonWeights(int n_replicas, std::uint64_t seed)
+    :   m_seed(seed)
+    ,   m_weights(n_replicas, 0.0f)
+    {
+        // u < thresholds[j] <=> w <= j, for uniform 32-bit u
+        double term = std::exp(-1.0);
+        double cdf = 0.0;
+        for (int j = 0; j < N_POISSON_THRESHOLDS; ++j)
+        {
+            cdf += term;
+            term /= j + 1;
+            m_thresholds[j] = static_cast<std::uint32_t>(std::min(cdf*4294967296.0, 4294967295.0));
+        }
+    }
+
+    inline void SetFile(TString const& file_name) { m_stream = Mix64(m_seed ^ HashName(file_name)); }
+
+    // weights of all replicas for entry of current file
+    // weight is the number of thresholds below u, loop has no branches and is vectorized
+    Float_t const* Generate(Long64_t entry)
+    {
+        std::uint64_t key = Mix64(m_stream + static_cast<std::uint64_t>(entry)*GOLDEN_GAMMA);
+        int n_replicas = m_weights.size();
+        for (int k = 0; k < n_replicas; ++k)
+        {
+            std::uint32_t u = Mix64(key + static_cast<std::uint64_t>(k + 1)*GOLDEN_GAMMA) >> 32;
+            int w = 0;
+            for (int j = 0; j < N_POISSON_THRESHOLDS; ++j)
+            {
+                w += u >= m_thresholds[j];
+            }
+            m_weights[k] = w;
+        }
+        return m_weights.data();
+    }
+
+    private:
+    static constexpr std::uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15ULL;
+
+    std::uint64_t m_seed;
+    std::uint64_t m_stream = 0;
+    std::array<std::uint32_t, N_POISSON_THRESHOLDS> m_thresholds;
+    std::vector<Float_t> m_weights;
+};
+
+#endif
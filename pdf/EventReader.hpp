@@ -0,0 +1,161 @@
+#ifndef EVENT_READER_HPP
+#define EVENT_READER_HPP
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+
+#include "TTree.h"
+#include "TLorentzVector.h"
+#include "TString.h"
+
+#include "Constants.hpp"
+#include "GenBranch.hpp"
+#include "MatchTree.hpp"
+
+// branches of one input file shared by PDF fillers of all channels
+// only branches needed by requested channels are connected
+class EventReader
+{
+    public:
+    EventReader(TTree* tree, bool sl, bool dl)
+    :   m_tree(tree)
+    {
+        m_tree->SetBranchAddress("ncentralJet", &ncentralJet);
+        m_tree->SetBranchAddress("centralJet_pt", centralJet_pt);
+        m_tree->SetBranchAddress("centralJet_eta", centralJet_eta);
+        m_tree->SetBranchAddress("centralJet_phi", centralJet_phi);
+        m_tree->SetBranchAddress("centralJet_mass", centralJet_mass);
+        m_tree->SetBranchAddress("centralJet_PNetRegPtRawCorr", centralJet_PNetRegPtRawCorr);
+        m_tree->SetBranchAddress("centralJet_PNetRegPtRawRes", centralJet_PNetRegPtRawRes);
+
+        m_tree->SetBranchAddress("lep1_pt", &lep1_pt);
+        m_tree->SetBranchAddress("lep1_eta", &lep1_eta);
+        m_tree->SetBranchAddress("lep1_phi", &lep1_phi);
+        m_tree->SetBranchAddress("lep1_mass", &lep1_mass);
+        m_tree->SetBranchAddress("lep1_type", &lep1_type);
+        m_tree->SetBranchAddress("lep1_genLep_kind", &lep1_genLep_kind);
+
+        genb1.Connect(m_tree, "genb1");
+        genb2.Connect(m_tree, "genb2");
+        genV1_mass.Connect(m_tree, "genV1_mass");
+        genV2_mass.Connect(m_tree, "genV2_mass");
+        genV1prod2.Connect(m_tree, "genV1prod2");
+        genV2prod1.Connect(m_tree, "genV2prod1");
+        genV2prod2.Connect(m_tree, "genV2prod2");
+
+        if (sl)
+        {
+            m_tree->SetBranchAddress("PuppiMET_pt", &PuppiMET_pt);
+            m_tree->SetBranchAddress("PuppiMET_phi", &PuppiMET_phi);
+
+            genHVV.Connect(m_tree, "genHVV");
+            genHbb.Connect(m_tree, "genHbb");
+        }
+
+        if (dl)
+        {
+            m_tree->SetBranchAddress("lep2_pt", &lep2_pt);
+            m_tree->SetBranchAddress("lep2_eta", &lep2_eta);
+            m_tree->SetBranchAddress("lep2_phi", &lep2_phi);
+            m_tree->SetBranchAddress("lep2_mass", &lep2_mass);
+            m_tree->SetBranchAddress("lep2_type", &lep2_type);
+            m_tree->SetBranchAddress("lep2_genLep_kind", &lep2_genLep_kind);
+
+            genV1prod1.Connect(m_tree, "genV1prod1");
+        }
+    }
+
+    EventReader(EventReader const&) = delete;
+    EventReader& operator=(EventReader const&) = delete;
+
+    inline Long64_t GetEntries() const { return m_tree->GetEntries(); }
+
+    // reads matching of requested channels from friend trees written by match_tree when they exist
+    void AttachMatches(TString const& input_name, bool sl, bool dl)
+    {
+        has_match_sl = sl && AttachMatchTree(m_tree, input_name, Channel::SL, match_sl);
+        has_match_dl = dl && AttachMatchTree(m_tree, input_name, Channel::DL, match_dl);
+        if (has_match_sl || has_match_dl)
+        {
+            m_tree->SetBranchAddress("event", &eventId);
+        }
+    }
+
+    // reads entry and decodes reco jets once for all channels
+    void GetEntry(Long64_t i)
+    {
+        m_tree->GetEntry(i);
+
+        if ((has_match_sl && match_sl.event != eventId) || (has_match_dl && match_dl.event != eventId))
+        {
+            throw std::runtime_error("Matching friend tree is not aligned with input tree, rerun match_tree");
+        }
+
+        jets.clear();
+        jet_resolutions.clear();
+        for (int j = 0; j < ncentralJet; ++j)
+        {
+            TLorentzVector jet;
+            jet.SetPtEtaPhiM(centralJet_pt[j], centralJet_eta[j], centralJet_phi[j], centralJet_mass[j]);
+            jets.push_back(jet);
+
+            jet *= centralJet_PNetRegPtRawCorr[j];
+            jet_resolutions.push_back(jet.Pt()*centralJet_PNetRegPtRawRes[j]);
+        }
+    }
+
+    ULong64_t eventId = 0;
+
+    Int_t ncentralJet = 0;
+    Float_t centralJet_pt[MAX_RECO_JET];
+    Float_t centralJet_eta[MAX_RECO_JET];
+    Float_t centralJet_phi[MAX_RECO_JET];
+    Float_t centralJet_mass[MAX_RECO_JET];
+    Float_t centralJet_PNetRegPtRawCorr[MAX_RECO_JET];
+    Float_t centralJet_PNetRegPtRawRes[MAX_RECO_JET];
+
+    Float_t lep1_pt;
+    Float_t lep1_eta;
+    Float_t lep1_phi;
+    Float_t lep1_mass;
+    Int_t lep1_type;
+    Int_t lep1_genLep_kind;
+
+    Float_t lep2_pt;
+    Float_t lep2_eta;
+    Float_t lep2_phi;
+    Float_t lep2_mass;
+    Int_t lep2_type;
+    Int_t lep2_genLep_kind;
+
+    Float_t PuppiMET_pt;
+    Float_t PuppiMET_phi;
+
+    GenP4Branches genHVV;
+    GenP4Branches genHbb;
+    GenP4Branches genb1;
+    GenP4Branches genb2;
+    // V1 is leptonic, V2 is hadronic in SL channel and leptonic in DL channel
+    // for leptonic W prod1 is lepton and prod2 is neutrino
+    GenP4Branches genV1prod1;
+    GenP4Branches genV1prod2;
+    GenP4Branches genV2prod1;
+    GenP4Branches genV2prod2;
+    GenBranch genV1_mass;
+    GenBranch genV2_mass;
+
+    // decoded reco jets and their pt resolutions
+    std::vector<TLorentzVector> jets;
+    std::vector<double> jet_resolutions;
+
+    MatchRecord match_sl;
+    MatchRecord match_dl;
+    bool has_match_sl = false;
+    bool has_match_dl = false;
+
+    private:
+    TTree* m_tree;
+};
+
+#endif
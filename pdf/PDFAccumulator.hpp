@@ -0,0 +1,334 @@
+#ifndef PDF_ACCUMULATOR_HPP
+#define PDF_ACCUMULATOR_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+
+#include "TFile.h"
+#include "TDirectory.h"
+#include "TNamed.h"
+#include "TH1.h"
+#include "TString.h"
+
+#include "Constants.hpp"
+#include "PDFRegistry.hpp"
+
+inline constexpr int N_PDF_BINS = 100;
+
+// PDFs read by estimator are named after pdf1d_sl_names and pdf2d_sl_names, the rest are auxiliary
+inline std::vector<PDFDef> PDFDefsSL()
+{
+    return { { pdf1d_sl_names.at(PDF1_sl::b1), "1d PDF for leading b jet correction", N_PDF_BINS, 0, 8 },
+             { "pdf_b2", "1d PDF for subleading b jet correction", N_PDF_BINS, 0, 8 },
+             { pdf1d_sl_names.at(PDF1_sl::q1), "1d PDF for leading light jet correction", N_PDF_BINS, 0, 8 },
+             { "pdf_q2", "1d PDF for subleading light jet correction", N_PDF_BINS, 0, 8 },
+             { pdf1d_sl_names.at(PDF1_sl::mbb), "1d PDF of H->bb mass with true corrections applied", N_PDF_BINS, 0, 200 },
+             { pdf1d_sl_names.at(PDF1_sl::hh_dphi), "1d PDF of dPhi between H->bb and H->WW", N_PDF_BINS, -4, 4 },
+             { pdf1d_sl_names.at(PDF1_sl::numet_pt), "1d PDF nu to met pt ratio with true corrections applied to b jets", N_PDF_BINS, 0, 8 },
+             { pdf1d_sl_names.at(PDF1_sl::numet_dphi), "1d PDF of dPhi between true nu and MET with true corrections applied to b jets", N_PDF_BINS, -4, 4 },
+             { "pdf_numet_pt_ext", "1d PDF nu to met pt ratio with true corrections applied to b jets and light jets", N_PDF_BINS, 0, 8 },
+             { "pdf_numet_dphi_ext", "1d PDF of dPhi between true nu and MET with true corrections applied to b jets and light jets", N_PDF_BINS, -4, 4 },
+             { pdf1d_sl_names.at(PDF1_sl::hh_deta), "1d PDF of dEta between H->bb and H->WW", N_PDF_BINS, -8, 8 },
+             { pdf2d_sl_names.at(PDF2_sl::b1b2), "2d PDF simultaneous b jet corrrections", N_PDF_BINS, 0, 8, N_PDF_BINS, 0, 8 },
+             { pdf2d_sl_names.at(PDF2_sl::q1q2), "2d PDF simultaneous light jet corrrections", N_PDF_BINS, 0, 8, N_PDF_BINS, 0, 8 },
+             { pdf1d_sl_names.at(PDF1_sl::nulep_deta), "1d PDF of dEta between true nu and reco lep", N_PDF_BINS, -8, 8 },
+             { pdf1d_sl_names.at(PDF1_sl::mww), "1d PDF of H->WW mass with best corrections applied", N_PDF_BINS, 0, 200 },
+             { "pdf_mww_wide", "1d PDF of H->WW mass", N_PDF_BINS, 0, 200 },
+             { pdf2d_sl_names.at(PDF2_sl::hh_dEtadPhi), "2d PDF dEta vs dPhi between H->bb and H->WW", N_PDF_BINS, -8, 8, N_PDF_BINS, -8, 8 },
+             { "pdf_mjj_off", "1d PDF of invariant mass of light jets when gen W->qq is offshell", N_PDF_BINS, 0, 200 },
+             { "pdf_mjj_on", "1d PDF of invariant mass of light jets when gen W->qq is onshell", N_PDF_BINS, 0, 200 },
+             { pdf2d_sl_names.at(PDF2_sl::hh_pt_e), "2d PDF of ratio pt to E of H->bb and H->WW", N_PDF_BINS, 0, 1, N_PDF_BINS, 0, 1 },
+             { "pdf_hbb_pt_e", "1d PDF of pt to E ratio for H->bb", N_PDF_BINS, 0, 1 },
+             { "pdf_hww_pt_e", "1d PDF of pt to E ratio for H->WW", N_PDF_BINS, 0, 1 },
+             { pdf2d_sl_names.at(PDF2_sl::mw1mw2), "2d PDF of onshell mw vs offshell mw", N_PDF_BINS, 0, 125, N_PDF_BINS, 0, 125 },
+             { pdf2d_sl_names.at(PDF2_sl::b1_pt), "2d PDF of leading b jet correction vs reco jet pt", N_PDF_BINS, 0, 8, N_COND_JET_PT_BINS, MIN_COND_JET_PT, MAX_COND_JET_PT },
+             { pdf2d_sl_names.at(PDF2_sl::q1_pt), "2d PDF of leading light jet correction vs reco jet pt", N_PDF_BINS, 0, 8, N_COND_JET_PT_BINS, MIN_COND_JET_PT, MAX_COND_JET_PT } };
+}
+
+// run2 b jet correction is a fixed table, it is filled after accumulation and is not normalized
+inline constexpr int N_RUN2_B1_BINS = 301;
+inline constexpr double MAX_RUN2_B1 = 6.0;
+
+inline std::vector<PDFDef> PDFDefsDL()
+{
+    PDFDef run2_b1{ pdf1d_dl_names.at(PDF1_dl::b1), "1d PDF for leading b jet correction", N_RUN2_B1_BINS, 0, MAX_RUN2_B1 };
+    run2_b1.normalize = false;
+
+    return { { "pdf_b1", "1d PDF for leading b jet correction", N_PDF_BINS, 0, 8 },
+             { "pdf_b2", "1d PDF for subleading b jet correction", N_PDF_BINS, 0, 8 },
+             { "pdf_mbb", "1d PDF of H->bb mass with true corrections applied", N_PDF_BINS, 0, 200 },
+             { "pdf_b1b2", "2d PDF simultaneous b jet corrrections", N_PDF_BINS, 0, 8, N_PDF_BINS, 0, 8 },
+             { pdf1d_dl_names.at(PDF1_dl::mw_onshell), "1d PDF of onshell W", N_PDF_BINS, 0, 100 },
+             { "pdf_mw_offshell", "1d PDF of offshell W", N_PDF_BINS, 0, 100 },
+             { pdf1d_dl_names.at(PDF1_dl::nulep_deta), "1d PDF of eta difference of neutrino and lepton from onshell W", N_PDF_BINS, -MAX_NU_ETA, MAX_NU_ETA },
+             { pdf1d_dl_names.at(PDF1_dl::nulep_dphi), "1d PDF of phi difference of neutrino and lepton from onshell W", N_PDF_BINS, -MAX_NU_PHI, MAX_NU_PHI },
+             { pdf2d_dl_names.at(PDF2_dl::b1_pt), "2d PDF of leading b jet correction vs reco jet pt", N_PDF_BINS, 0, 8, N_COND_JET_PT_BINS, MIN_COND_JET_PT, MAX_COND_JET_PT },
+             run2_b1 };
+}
+
+inline void FillRun2BJetCorrection(TH1* hist)
+{
+    std::vector<double> yval = {0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   2.0,   1.0,   4.0,   6.0,   7.0,   4.0,   4.0,   4.0,   9.0,
+        6.0,   16.0,  8.0,   7.0,   8.0,   5.0,   6.0,   5.0,   4.0,   8.0,   14.0,  7.0,   21.0,  9.0,   7.0,   14.0,
+        15.0,  16.0,  9.0,   19.0,  17.0,  28.0,  24.0,  40.0,  51.0,  58.0,  73.0,  88.0,  126.0, 173.0, 269.0, 371.0,
+        474.0, 594.0, 695.0, 702.0, 777.0, 735.0, 742.0, 636.0, 593.0, 467.0, 458.0, 392.0, 383.0, 341.0, 319.0, 293.0,
+        270.0, 239.0, 204.0, 184.0, 154.0, 151.0, 153.0, 133.0, 127.0, 101.0, 104.0, 120.0, 77.0,  70.0,  61.0,  57.0,
+        74.0,  57.0,  73.0,  59.0,  56.0,  47.0,  30.0,  24.0,  38.0,  46.0,  33.0,  32.0,  21.0,  29.0,  30.0,  21.0,
+        18.0,  25.0,  20.0,  17.0,  19.0,  6.0,   11.0,  14.0,  14.0,  9.0,   12.0,  4.0,   10.0,  11.0,  7.0,   5.0,
+        7.0,   4.0,   5.0,   4.0,   8.0,   3.0,   2.0,   0.0,   2.0,   8.0,   6.0,   5.0,   0.0,   2.0,   2.0,   6.0,
+        2.0,   1.0,   1.0,   1.0,   0.0,   2.0,   4.0,   0.0,   1.0,   2.0,   0.0,   2.0,   1.0,   2.0,   3.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   1.0,   0.0,   1.0,   0.0,   0.0,   0.0,   1.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   1.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,
+        0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0,   0.0};
+
+    for (size_t i = 0; i < yval.size(); ++i)
+    {
+        hist->SetBinContent(i + 1, yval[i]);
+    }
+}
+
+// every PDF read by estimator must be produced by registry of its channel
+inline void ValidateRegistry(PDFSet const& sl, PDFSet const& dl)
+{
+    auto check = [](PDFSet const& pdfs, TString const& name, TString const& ch)
+    {
+        if (!pdfs.Has(name))
+        {
+            throw std::runtime_error(std::string(ch.Data()) + " PDF " + name.Data() + " used by estimator is not registered");
+        }
+    };
+
+    for (auto const& [pdf, name]: pdf1d_sl_names)
+    {
+        check(sl, name, "SL");
+    }
+    for (auto const& [pdf, name]: pdf2d_sl_names)
+    {
+        check(sl, name, "SL");
+    }
+    for (auto const& [pdf, name]: pdf1d_dl_names)
+    {
+        check(dl, name, "DL");
+    }
+    for (auto const& [pdf, name]: pdf2d_dl_names)
+    {
+        check(dl, name, "DL");
+    }
+}
+
+// version of selection and PDF definitions
+// bump it when either changes: partial accumulators of other versions are rebuilt
+inline constexpr int PDF_BUILDER_VERSION = 2;
+
+// light jet rescaling of pdf_mww selected at build time, see DijetScales
+#ifdef MOST_PROBABLE_DIJET
+    inline constexpr char const* DIJET_METHOD = "most_probable";
+#else
+    inline constexpr char const* DIJET_METHOD = "sampled";
+#endif
+
+// origin of partial accumulator, stored next to its histograms
+// source size and modification time are -1 if source is not a local file
+// bootstrap seed is 0 if there are no replicas
+struct Provenance
+{
+    TString source;
+    bool sl = false;
+    bool dl = false;
+    Long64_t source_size = -1;
+    Long64_t source_mtime = -1;
+    int version = PDF_BUILDER_VERSION;
+    TString dijet_method = DIJET_METHOD;
+    int n_replicas = 0;
+    std::uint64_t bootstrap_seed = 0;
+};
+
+inline bool operator==(Provenance const& lhs, Provenance const& rhs)
+{
+    return lhs.source == rhs.source && lhs.sl == rhs.sl && lhs.dl == rhs.dl && lhs.source_size == rhs.source_size
+           && lhs.source_mtime == rhs.source_mtime && lhs.version == rhs.version && lhs.dijet_method == rhs.dijet_method
+           && lhs.n_replicas == rhs.n_replicas && lhs.bootstrap_seed == rhs.bootstrap_seed;
+}
+
+// unnormalized PDFs of both channels
+// partial accumulator file layout: directories "sl" and "dl" with raw histograms and
+// directory "provenance" with one TNamed per field, value stored in title
+struct PDFAccumulator
+{
+    PDFAccumulator()
+    :   sl(PDFDefsSL())
+    ,   dl(PDFDefsDL())
+    {}
+
+    // bootstrap mode: every PDF gets n_replicas Poisson-weighted replicas
+    void BookReplicas(int n, std::uint64_t seed)
+    {
+        sl.BookReplicas(n);
+        dl.BookReplicas(n);
+        n_replicas = n;
+        bootstrap_seed = n > 0 ? seed : 0;
+    }
+
+    void Add(PDFAccumulator const& other)
+    {
+        sl.Add(other.sl);
+        dl.Add(other.dl);
+        n_events += other.n_events;
+        n_selected_sl += other.n_selected_sl;
+        n_selected_dl += other.n_selected_dl;
+    }
+
+    void WritePartial(TString const& file_name, Provenance const& prov) const
+    {
+        auto file = std::make_unique<TFile>(file_name, "RECREATE");
+        if (file->IsZombie())
+        {
+            throw std::runtime_error("Unable to create partial file " + std::string(file_name.Data()));
+        }
+
+        file->mkdir("sl")->cd();
+        sl.Write();
+        file->mkdir("dl")->cd();
+        dl.Write();
+
+        TDirectory* dir = file->mkdir("provenance");
+        auto write_field = [dir](char const* key, TString const& value)
+        {
+            TNamed field(key, value.Data());
+            dir->WriteTObject(&field);
+        };
+        write_field("source", prov.source);
+        write_field("sl", TString::Format("%d", prov.sl));
+        write_field("dl", TString::Format("%d", prov.dl));
+        write_field("source_size", TString::Format("%lld", prov.source_size));
+        write_field("source_mtime", TString::Format("%lld", prov.source_mtime));
+        write_field("version", TString::Format("%d", prov.version));
+        write_field("dijet_method", prov.dijet_method);
+        write_field("n_replicas", TString::Format("%d", prov.n_replicas));
+        write_field("bootstrap_seed", TString::Format("%llu", static_cast<unsigned long long>(prov.bootstrap_seed)));
+        write_field("n_events", TString::Format("%lld", n_events));
+        write_field("n_selected_sl", TString::Format("%lld", n_selected_sl));
+        write_field("n_selected_dl", TString::Format("%lld", n_selected_dl));
+        file->Close();
+    }
+
+    // adds histograms and counters of partial file, returns its provenance
+    Provenance AddPartial(TString const& file_name)
+    {
+        auto file = std::unique_ptr<TFile>(TFile::Open(file_name));
+        if (!file || file->IsZombie())
+        {
+            throw std::runtime_error("Unable to open partial file " + std::string(file_name.Data()));
+        }
+
+        Provenance prov = ReadProvenance(file.get());
+        if (prov.n_replicas != n_replicas || prov.bootstrap_seed != bootstrap_seed)
+        {
+            throw std::runtime_error("Partial file " + std::string(file_name.Data()) + " has different bootstrap replicas");
+        }
+        sl.AddFrom(file->GetDirectory("sl"));
+        dl.AddFrom(file->GetDirectory("dl"));
+        n_events += ReadField(file.get(), "n_events").Atoll();
+        n_selected_sl += ReadField(file.get(), "n_selected_sl").Atoll();
+        n_selected_dl += ReadField(file.get(), "n_selected_dl").Atoll();
+        return prov;
+    }
+
+    // fixed tables are filled and PDFs are scaled to unit maximum, accumulator can not be merged after this
+    void Finalize()
+    {
+        TString run2_b1 = pdf1d_dl_names.at(PDF1_dl::b1);
+        FillRun2BJetCorrection(dl.Get(run2_b1));
+        for (int k = 0; k < n_replicas; ++k)
+        {
+            FillRun2BJetCorrection(dl.GetReplica(run2_b1, k));
+        }
+        sl.Normalize();
+        dl.Normalize();
+    }
+
+    static TString ReadField(TFile* file, char const* key)
+    {
+        TNamed* field = file->Get<TNamed>(TString::Format("provenance/%s", key));
+        if (!field)
+        {
+            throw std::runtime_error("Partial file has no provenance field " + std::string(key));
+        }
+        TString value = field->GetTitle();
+        delete field;
+        return value;
+    }
+
+    static Provenance ReadProvenance(TFile* file)
+    {
+        Provenance prov;
+        prov.source = ReadField(file, "source");
+        prov.sl = ReadField(file, "sl").Atoi();
+        prov.dl = ReadField(file, "dl").Atoi();
+        prov.source_size = ReadField(file, "source_size").Atoll();
+        prov.source_mtime = ReadField(file, "source_mtime").Atoll();
+        prov.version = ReadField(file, "version").Atoi();
+        prov.dijet_method = ReadField(file, "dijet_method");
+        prov.n_replicas = ReadField(file, "n_replicas").Atoi();
+        prov.bootstrap_seed = std::stoull(ReadField(file, "bootstrap_seed").Data());
+        return prov;
+    }
+
+    PDFSet sl;
+    PDFSet dl;
+    Long64_t n_events = 0;
+    Long64_t n_selected_sl = 0;
+    Long64_t n_selected_dl = 0;
+    int n_replicas = 0;
+    std::uint64_t bootstrap_seed = 0;
+};
+
+// sums partial files in given order, so result does not depend on how partials were produced
+// bootstrap replicas are booked as in the first partial, all partials must have the same
+inline std::unique_ptr<PDFAccumulator> MergePartials(std::vector<TString> const& partial_files)
+{
+    TH1::AddDirectory(false);
+    auto acc = std::make_unique<PDFAccumulator>();
+    if (!partial_files.empty())
+    {
+        auto file = std::unique_ptr<TFile>(TFile::Open(partial_files.front()));
+        if (!file || file->IsZombie())
+        {
+            throw std::runtime_error("Unable to open partial file " + std::string(partial_files.front().Data()));
+        }
+        Provenance prov = PDFAccumulator::ReadProvenance(file.get());
+        acc->BookReplicas(prov.n_replicas, prov.bootstrap_seed);
+    }
+
+    for (auto const& partial: partial_files)
+    {
+        acc->AddPartial(partial);
+    }
+    return acc;
+}
+
+inline void WritePDFs(PDFAccumulator const& acc, TString const& sl_file_name, TString const& dl_file_name)
+{
+    auto output_sl = std::make_unique<TFile>(sl_file_name, "RECREATE");
+    acc.sl.Write();
+    output_sl->Write();
+    output_sl->Close();
+
+    auto output_dl = std::make_unique<TFile>(dl_file_name, "RECREATE");
+    acc.dl.Write();
+    output_dl->Write();
+    output_dl->Close();
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef PDF_BUILDER_HPP
+#define PDF_BUILDER_HPP
+
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <string>
+
+#include "TString.h"
+#include "TROOT.h"
+#include "TH1.h"
+
+inline std::vector<TString> ReadFileList(TString const& list_name)
+{
+    std::vector<TString> input_files;
+    std::ifstream files(list_name.Data());
+    std::string fname;
+    while (files >> fname)
+    {
+        input_files.push_back(fname);
+    }
+    return input_files;
+}
+
+// calls process(idx) for idx in [0, n_items) on n_threads workers, items are taken in increasing order
+// process must only touch state owned by item idx
+// the first exception thrown by a worker is rethrown after all workers are joined
+template <typename Process>
+void ForEachParallel(size_t n_items, unsigned n_threads, Process process)
+{
+    ROOT::EnableThreadSafety();
+    TH1::AddDirectory(false);
+
+    if (n_items == 0)
+    {
+        return;
+    }
+    n_threads = std::max(1u, std::min<unsigned>(n_threads, n_items));
+
+    std::vector<std::exception_ptr> errors(n_threads);
+    std::atomic<size_t> next_item{0};
+
+    auto worker = [&](unsigned thread_idx)
+    {
+        try
+        {
+            for (size_t idx = next_item++; idx < n_items; idx = next_item++)
+            {
+                process(idx);
+            }
+        }
+        catch (...)
+        {
+            errors[thread_idx] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < n_threads; ++t)
+    {
+        threads.emplace_back(worker, t);
+    }
+
+    for (auto& t: threads)
+    {
+        t.join();
+    }
+
+    for (auto const& err: errors)
+    {
+        if (err)
+        {
+            std::rethrow_exception(err);
+        }
+    }
+}
+
+#endif
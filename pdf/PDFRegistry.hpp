@@ -0,0 +1,298 @@
+#ifndef PDF_REGISTRY_HPP
+#define PDF_REGISTRY_HPP
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <string>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+
+#include "TString.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TDirectory.h"
+
+#include "PDFTools.hpp"
+
+// definition of a single PDF histogram
+// 2d PDFs have nbins_y > 0
+struct PDFDef
+{
+    TString name;
+    TString title;
+    int nbins_x;
+    double xmin;
+    double xmax;
+    int nbins_y = 0;
+    double ymin = 0.0;
+    double ymax = 0.0;
+    // PDFs are scaled to unit maximum before writing unless they are fixed tables
+    bool normalize = true;
+
+    inline bool Is2D() const { return nbins_y > 0; }
+};
+
+inline std::unique_ptr<TH1> BookPDF(PDFDef const& def, TString const& name)
+{
+    if (def.Is2D())
+    {
+        return std::make_unique<TH2F>(name, def.title, def.nbins_x, def.xmin, def.xmax, def.nbins_y, def.ymin, def.ymax);
+    }
+    return std::make_unique<TH1F>(name, def.title, def.nbins_x, def.xmin, def.xmax);
+}
+
+// bootstrap replica k of PDF is named <name>_bs<k> and is stored in subdirectory "bootstrap"
+inline TString ReplicaName(TString const& name, int k)
+{
+    return TString::Format("%s_bs%d", name.Data(), k);
+}
+
+// set of histograms booked from a list of definitions
+// histograms are looked up by name once per input file and filled through handles
+// optionally every histogram has bootstrap replicas: bins filled by the current event are recorded
+// and added to all replicas with their weights when the event is committed
+class PDFSet
+{
+    public:
+    PDFSet() = default;
+    explicit PDFSet(std::vector<PDFDef> const& defs)
+    :   m_defs(defs)
+    {
+        for (auto const& def: m_defs)
+        {
+            m_index[def.name.Data()] = m_hists.size();
+            m_hists.push_back(BookPDF(def, def.name));
+        }
+    }
+
+    inline bool Has(TString const& name) const { return m_index.count(name.Data()); }
+
+    size_t Index(TString const& name) const
+    {
+        auto it = m_index.find(name.Data());
+        if (it == m_index.end())
+        {
+            throw std::runtime_error("PDF " + std::string(name.Data()) + " is not registered");
+        }
+        return it->second;
+    }
+
+    inline TH1* Get(TString const& name) const { return m_hists[Index(name)].get(); }
+
+    TH2* Get2D(TString const& name) const
+    {
+        TH2* hist = dynamic_cast<TH2*>(Get(name));
+        if (!hist)
+        {
+            throw std::runtime_error("PDF " + std::string(name.Data()) + " is not 2d");
+        }
+        return hist;
+    }
+
+    // books n_replicas empty replicas of every histogram
+    void BookReplicas(int n_replicas)
+    {
+        m_n_replicas = n_replicas;
+        m_replicas.clear();
+        m_replica_counts.clear();
+        for (size_t i = 0; i < m_hists.size(); ++i)
+        {
+            for (int k = 0; k < n_replicas; ++k)
+            {
+                m_replicas.push_back(BookPDF(m_defs[i], ReplicaName(m_defs[i].name, k)));
+            }
+            m_replica_counts.emplace_back(static_cast<size_t>(m_hists[i]->GetNcells())*n_replicas, 0.0f);
+        }
+    }
+
+    inline int NumReplicas() const { return m_n_replicas; }
+
+    TH1* GetReplica(TString const& name, int k) const
+    {
+        return m_replicas[Index(name)*m_n_replicas + k].get();
+    }
+
+    // bin of histogram idx filled by the current event, negative bins are ignored
+    inline void Record(size_t idx, int bin)
+    {
+        if (m_n_replicas > 0 && bin >= 0)
+        {
+            m_pending.emplace_back(idx, bin);
+        }
+    }
+
+    inline bool HasPending() const { return !m_pending.empty(); }
+
+    // adds bins recorded for the current event to replica k with weights[k]
+    // counts of a bin are contiguous in replicas, so the inner loop is vectorized
+    void CommitReplicas(Float_t const* weights)
+    {
+        for (auto const& [idx, bin]: m_pending)
+        {
+            Float_t* counts = m_replica_counts[idx].data() + static_cast<size_t>(bin)*m_n_replicas;
+            for (int k = 0; k < m_n_replicas; ++k)
+            {
+                counts[k] += weights[k];
+            }
+        }
+        m_pending.clear();
+    }
+
+    // moves committed counts to replica histograms
+    void FlushReplicas()
+    {
+        for (size_t i = 0; i < m_replica_counts.size(); ++i)
+        {
+            std::vector<Float_t>& counts = m_replica_counts[i];
+            int n_cells = m_hists[i]->GetNcells();
+            for (int k = 0; k < m_n_replicas; ++k)
+            {
+                TH1* replica = m_replicas[i*m_n_replicas + k].get();
+                for (int bin = 0; bin < n_cells; ++bin)
+                {
+                    Float_t& count = counts[static_cast<size_t>(bin)*m_n_replicas + k];
+                    if (count != 0.0f)
+                    {
+                        replica->AddBinContent(bin, count);
+                        count = 0.0f;
+                    }
+                }
+                replica->ResetStats();
+            }
+        }
+    }
+
+    void Add(PDFSet const& other)
+    {
+        for (size_t i = 0; i < m_hists.size(); ++i)
+        {
+            m_hists[i]->Add(other.m_hists[i].get());
+        }
+        for (size_t i = 0; i < m_replicas.size(); ++i)
+        {
+            m_replicas[i]->Add(other.m_replicas[i].get());
+        }
+    }
+
+    // replicas are normalized in the same way as their PDFs
+    void Normalize()
+    {
+        for (size_t i = 0; i < m_hists.size(); ++i)
+        {
+            if (!m_defs[i].normalize)
+            {
+                continue;
+            }
+
+            m_hists[i]->Scale(1.0/GetPDFScaleFactor(m_hists[i].get()));
+            for (int k = 0; k < m_n_replicas; ++k)
+            {
+                TH1* replica = m_replicas[i*m_n_replicas + k].get();
+                replica->Scale(1.0/GetPDFScaleFactor(replica));
+            }
+        }
+    }
+
+    // writes to current directory in order of definitions, replicas go to its subdirectory "bootstrap"
+    void Write() const
+    {
+        for (auto const& hist: m_hists)
+        {
+            hist->Write();
+        }
+
+        if (m_n_replicas > 0)
+        {
+            TDirectory* dir = gDirectory;
+            dir->mkdir("bootstrap")->cd();
+            for (auto const& replica: m_replicas)
+            {
+                replica->Write();
+            }
+            dir->cd();
+        }
+    }
+
+    // adds histograms with the same names stored in dir, e.g. in a partial accumulator file
+    void AddFrom(TDirectory* dir)
+    {
+        auto add = [](TDirectory* src, TString const& name, TH1* dst)
+        {
+            std::unique_ptr<TH1> hist(src->Get<TH1>(name));
+            if (!hist)
+            {
+                throw std::runtime_error("PDF " + std::string(name.Data()) + " is missing in partial file");
+            }
+            dst->Add(hist.get());
+        };
+
+        for (size_t i = 0; i < m_hists.size(); ++i)
+        {
+            add(dir, m_defs[i].name, m_hists[i].get());
+        }
+
+        if (m_n_replicas > 0)
+        {
+            TDirectory* bootstrap_dir = dir->GetDirectory("bootstrap");
+            if (!bootstrap_dir)
+            {
+                throw std::runtime_error("Partial file has no bootstrap replicas");
+            }
+            for (size_t i = 0; i < m_hists.size(); ++i)
+            {
+                for (int k = 0; k < m_n_replicas; ++k)
+                {
+                    add(bootstrap_dir, ReplicaName(m_defs[i].name, k), m_replicas[i*m_n_replicas + k].get());
+                }
+            }
+        }
+    }
+
+    private:
+    std::vector<PDFDef> m_defs;
+    std::vector<std::unique_ptr<TH1>> m_hists;
+    std::unordered_map<std::string, size_t> m_index;
+
+    // replica k of histogram i is m_replicas[i*m_n_replicas + k]
+    // committed counts of histogram i are m_replica_counts[i][bin*m_n_replicas + k] until flushed
+    int m_n_replicas = 0;
+    std::vector<std::unique_ptr<TH1>> m_replicas;
+    std::vector<std::vector<Float_t>> m_replica_counts;
+    std::vector<std::pair<size_t, int>> m_pending;
+};
+
+// fills PDF of a set and records filled bin for its bootstrap replicas
+// Hist is TH1 or TH2, so Fill(x, y) of a 2d PDF can not be mistaken for weighted 1d fill
+template <typename Hist>
+class PDFHandle
+{
+    public:
+    PDFHandle(PDFSet& pdfs, TString const& name)
+    :   m_pdfs(&pdfs)
+    ,   m_idx(pdfs.Index(name))
+    {
+        if constexpr (std::is_same_v<Hist, TH2>)
+        {
+            m_hist = pdfs.Get2D(name);
+        }
+        else
+        {
+            m_hist = pdfs.Get(name);
+        }
+    }
+
+    template <typename... Coords>
+    inline void Fill(Coords... coords) const
+    {
+        m_pdfs->Record(m_idx, m_hist->Fill(coords...));
+    }
+
+    private:
+    PDFSet* m_pdfs;
+    size_t m_idx;
+    Hist* m_hist = nullptr;
+};
+
+#endif
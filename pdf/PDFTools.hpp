@@ -0,0 +1,133 @@
+#ifndef PDF_TOOLS_HPP
+#define PDF_TOOLS_HPP
+
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "TLorentzVector.h"
+#include "TRandom3.h"
+#include "TH1.h"
+
+// number of sampled resolution corrections per event in ClosestSampledDijetScales
+inline constexpr int N_DIJET_SAMPLES = 1000;
+
+// PDFs are normalized to unit maximum
+inline double GetPDFScaleFactor(TH1 const* hist)
+{
+    int binmax = hist->GetMaximumBin();
+    return hist->GetBinContent(binmax);
+}
+
+inline bool CorrectLepReco(int lep_type, int lep_genLep_kind)
+{
+    bool reco_lep_mu = (lep_type == 2);
+    bool reco_lep_ele = (lep_type == 1);
+
+    bool gen_lep_mu = ((lep_genLep_kind == 2) || (lep_genLep_kind == 4));
+    bool gen_lep_ele = ((lep_genLep_kind == 1) || (lep_genLep_kind == 3));
+
+    bool corr_lep_reco = ((reco_lep_mu && gen_lep_mu) || (reco_lep_ele && gen_lep_ele));
+    return corr_lep_reco;
+}
+
+// most probable pt scale factors (s1, s2) of two jets with gaussian pt resolutions res1, res2
+// under the condition that their invariant mass equals target_mass, i.e. maximum of the likelihood on the curve m(s1, s2) = target_mass
+// this is a different estimator than ClosestSampledDijetScales, not its limit: the closest of many samples is a random point
+// near the curve distributed as the likelihood restricted to it, so it scatters around this maximum event by event
+// every event enters pdf_mww at its most likely rescaling, without sampling noise and without N_DIJET_SAMPLES samples per event,
+// so it changes the shape of pdf_mww_narrow and is opt-in (make MOST_PROBABLE_DIJET=1) until PDFs of both methods are compared on real inputs
+// jet masses are neglected in the constraint, i.e. m^2 ~ s1*s2
+inline std::pair<double, double> MostProbableDijetScales(TLorentzVector const& j1, double res1,
+                                                         TLorentzVector const& j2, double res2,
+                                                         double target_mass)
+{
+    double mjj = (j1 + j2).M();
+    if (mjj <= 0.0 || target_mass <= 0.0 || res1 <= 0.0 || res2 <= 0.0)
+    {
+        return {1.0, 1.0};
+    }
+
+    // chi2(s1) = a^2*(s1 - 1)^2 + b^2*(k/s1 - 1)^2, k = s1*s2
+    // dchi2/ds1 = 0 <=> g(s1) = a^2*s1^4 - a^2*s1^3 + b^2*k*s1 - b^2*k^2 = 0
+    double a2 = j1.Pt()*j1.Pt()/(res1*res1);
+    double b2 = j2.Pt()*j2.Pt()/(res2*res2);
+    double k = target_mass*target_mass/(mjj*mjj);
+
+    auto g = [a2, b2, k](double s) { return a2*s*s*s*(s - 1.0) + b2*k*(s - k); };
+
+    // g(0) < 0 and g(max(1, k)) >= 0: bisection always converges to a root
+    double lo = 0.0;
+    double hi = std::max(1.0, k);
+    for (int i = 0; i < 50; ++i)
+    {
+        double mid = 0.5*(lo + hi);
+        if (g(mid) < 0.0)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    double s1 = 0.5*(lo + hi);
+    return {s1, k/s1};
+}
+
+// default method: jet pt are smeared n_samples times with gaussian resolutions (truncated at pt = 0),
+// scale factors of the pair with dijet mass closest to target_mass are returned; no allocation per event
+inline std::pair<double, double> ClosestSampledDijetScales(TLorentzVector const& j1, double res1,
+                                                           TLorentzVector const& j2, double res2,
+                                                           double target_mass, TRandom3& rg, int n_samples = N_DIJET_SAMPLES)
+{
+    auto smear = [&rg](TLorentzVector const& v, double res)
+    {
+        double dpt = rg.Gaus(0, res);
+        while (v.Pt() + dpt < 0.0)
+        {
+            dpt = rg.Gaus(0, res);
+        }
+        TLorentzVector result;
+        result.SetPtEtaPhiM(v.Pt() + dpt, v.Eta(), v.Phi(), v.M());
+        return result;
+    };
+
+    std::pair<double, double> best = {1.0, 1.0};
+    double mass_diff = 10e4;
+    for (int i = 0; i < n_samples; ++i)
+    {
+        TLorentzVector j1_corr = smear(j1, res1);
+        TLorentzVector j2_corr = smear(j2, res2);
+        double dm = std::abs((j1_corr + j2_corr).M() - target_mass);
+        if (dm < mass_diff)
+        {
+            mass_diff = dm;
+            best = {j1_corr.Pt()/j1.Pt(), j2_corr.Pt()/j2.Pt()};
+        }
+    }
+    return best;
+}
+
+// light jet scale factors used for pdf_mww, make MOST_PROBABLE_DIJET=1 selects the most probable scales to compare PDFs and timing
+inline std::pair<double, double> DijetScales(TLorentzVector const& j1, double res1,
+                                             TLorentzVector const& j2, double res2,
+                                             double target_mass, [[maybe_unused]] TRandom3& rg)
+{
+    #ifdef MOST_PROBABLE_DIJET
+        return MostProbableDijetScales(j1, res1, j2, res2, target_mass);
+    #else
+        return ClosestSampledDijetScales(j1, res1, j2, res2, target_mass, rg);
+    #endif
+}
+
+inline TLorentzVector ScalePt(TLorentzVector const& v, double scale)
+{
+    TLorentzVector result;
+    result.SetPtEtaPhiM(scale*v.Pt(), v.Eta(), v.Phi(), v.M());
+    return result;
+}
+
+#endif
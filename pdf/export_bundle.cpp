@@ -0,0 +1,55 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include "TFile.h"
+#include "TH1.h"
+#include "TString.h"
+
+#include "PDFAccumulator.hpp"
+#include "PDFBundle.hpp"
+
+// converts PDFs written by pdfs/merge_pdfs to memory-mappable bundles read by the analyzer
+// usage: export_bundle [pdf_sl.root] [pdf_dl.root]
+// output names are input names with .root replaced by .bundle
+void ExportBundle(TString const& input_name, std::vector<PDFDef> const& defs)
+{
+    std::unique_ptr<TFile> input(TFile::Open(input_name));
+    if (!input || input->IsZombie())
+    {
+        throw std::runtime_error("Unable to open " + std::string(input_name.Data()));
+    }
+
+    std::vector<std::unique_ptr<TH1>> hists;
+    std::vector<TH1 const*> hist_ptrs;
+    for (auto const& def: defs)
+    {
+        std::unique_ptr<TH1> hist(input->Get<TH1>(def.name));
+        if (!hist)
+        {
+            throw std::runtime_error("PDF " + std::string(def.name.Data()) + " is missing in " + std::string(input_name.Data()));
+        }
+        hist_ptrs.push_back(hist.get());
+        hists.push_back(std::move(hist));
+    }
+
+    TString output_name = input_name;
+    output_name.ReplaceAll(".root", "");
+    output_name += ".bundle";
+    WritePDFBundle(output_name, hist_ptrs);
+
+    std::cout << "Exported " << hists.size() << " PDFs from " << input_name << " to " << output_name << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+    TH1::AddDirectory(false);
+
+    TString sl_name = argc > 1 ? argv[1] : "pdf_sl.root";
+    TString dl_name = argc > 2 ? argv[2] : "pdf_dl.root";
+
+    ExportBundle(sl_name, PDFDefsSL());
+    ExportBundle(dl_name, PDFDefsDL());
+    return 0;
+}
@@ -0,0 +1,27 @@
+#include <iostream>
+#include <vector>
+
+#include "TString.h"
+
+#include "PDFAccumulator.hpp"
+
+// merges partial accumulators written by pdfs and normalizes result
+// usage: merge_pdfs partial_1.root [partial_2.root ...]
+// partials are summed in command line order
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " partial_1.root [partial_2.root ...]\n";
+        return 1;
+    }
+
+    std::vector<TString> partial_files(argv + 1, argv + argc);
+    auto pdfs = MergePartials(partial_files);
+    pdfs->Finalize();
+    WritePDFs(*pdfs, "pdf_sl.root", "pdf_dl.root");
+
+    std::cout << "Merged " << partial_files.size() << " partials with " << pdfs->n_events << " events ("
+              << pdfs->n_selected_sl << " SL, " << pdfs->n_selected_dl << " DL selected)\n";
+    return 0;
+}
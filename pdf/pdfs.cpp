@@ -0,0 +1,540 @@
+#include <iostream>
+#include <algorithm>
+#include <memory>
+#include <cmath>
+#include <thread>
+#include <stdexcept>
+#include <chrono>
+#include <atomic>
+#include <filesystem>
+#include <system_error>
+
+#include "TTree.h"
+#include "TFile.h"
+#include "TLorentzVector.h"
+#include "TVector2.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TString.h"
+#include "TRandom3.h"
+
+#include "Constants.hpp"
+#include "PDFBuilder.hpp"
+#include "PDFTools.hpp"
+#include "PDFRegistry.hpp"
+#include "PDFAccumulator.hpp"
+#include "EventReader.hpp"
+#include "Bootstrap.hpp"
+#include "JetAssignment.hpp"
+
+// histograms are resolved by name once per file
+struct HandlesSL
+{
+    explicit HandlesSL(PDFSet& pdfs)
+    :   b1(pdfs, pdf1d_sl_names.at(PDF1_sl::b1))
+    ,   b2(pdfs, "pdf_b2")
+    ,   q1(pdfs, pdf1d_sl_names.at(PDF1_sl::q1))
+    ,   q2(pdfs, "pdf_q2")
+    ,   mbb(pdfs, pdf1d_sl_names.at(PDF1_sl::mbb))
+    ,   hh_dphi(pdfs, pdf1d_sl_names.at(PDF1_sl::hh_dphi))
+    ,   numet_pt(pdfs, pdf1d_sl_names.at(PDF1_sl::numet_pt))
+    ,   numet_dphi(pdfs, pdf1d_sl_names.at(PDF1_sl::numet_dphi))
+    ,   numet_pt_ext(pdfs, "pdf_numet_pt_ext")
+    ,   numet_dphi_ext(pdfs, "pdf_numet_dphi_ext")
+    ,   hh_deta(pdfs, pdf1d_sl_names.at(PDF1_sl::hh_deta))
+    ,   nulep_deta(pdfs, pdf1d_sl_names.at(PDF1_sl::nulep_deta))
+    ,   mww_narrow(pdfs, pdf1d_sl_names.at(PDF1_sl::mww))
+    ,   mww_wide(pdfs, "pdf_mww_wide")
+    ,   mjj_off(pdfs, "pdf_mjj_off")
+    ,   mjj_on(pdfs, "pdf_mjj_on")
+    ,   hbb_pt_e(pdfs, "pdf_hbb_pt_e")
+    ,   hww_pt_e(pdfs, "pdf_hww_pt_e")
+    ,   b1b2(pdfs, pdf2d_sl_names.at(PDF2_sl::b1b2))
+    ,   q1q2(pdfs, pdf2d_sl_names.at(PDF2_sl::q1q2))
+    ,   mw1mw2(pdfs, pdf2d_sl_names.at(PDF2_sl::mw1mw2))
+    ,   hh_dEtadPhi(pdfs, pdf2d_sl_names.at(PDF2_sl::hh_dEtadPhi))
+    ,   hh_pt_e(pdfs, pdf2d_sl_names.at(PDF2_sl::hh_pt_e))
+    ,   b1_pt(pdfs, pdf2d_sl_names.at(PDF2_sl::b1_pt))
+    ,   q1_pt(pdfs, pdf2d_sl_names.at(PDF2_sl::q1_pt))
+    {}
+
+    PDFHandle<TH1> b1;
+    PDFHandle<TH1> b2;
+    PDFHandle<TH1> q1;
+    PDFHandle<TH1> q2;
+    PDFHandle<TH1> mbb;
+    PDFHandle<TH1> hh_dphi;
+    PDFHandle<TH1> numet_pt;
+    PDFHandle<TH1> numet_dphi;
+    PDFHandle<TH1> numet_pt_ext;
+    PDFHandle<TH1> numet_dphi_ext;
+    PDFHandle<TH1> hh_deta;
+    PDFHandle<TH1> nulep_deta;
+    PDFHandle<TH1> mww_narrow;
+    PDFHandle<TH1> mww_wide;
+    PDFHandle<TH1> mjj_off;
+    PDFHandle<TH1> mjj_on;
+    PDFHandle<TH1> hbb_pt_e;
+    PDFHandle<TH1> hww_pt_e;
+    PDFHandle<TH2> b1b2;
+    PDFHandle<TH2> q1q2;
+    PDFHandle<TH2> mw1mw2;
+    PDFHandle<TH2> hh_dEtadPhi;
+    PDFHandle<TH2> hh_pt_e;
+    PDFHandle<TH2> b1_pt;
+    PDFHandle<TH2> q1_pt;
+};
+
+struct HandlesDL
+{
+    explicit HandlesDL(PDFSet& pdfs)
+    :   b1(pdfs, "pdf_b1")
+    ,   b2(pdfs, "pdf_b2")
+    ,   mbb(pdfs, "pdf_mbb")
+    ,   mw_onshell(pdfs, pdf1d_dl_names.at(PDF1_dl::mw_onshell))
+    ,   mw_offshell(pdfs, "pdf_mw_offshell")
+    ,   nulep_deta(pdfs, pdf1d_dl_names.at(PDF1_dl::nulep_deta))
+    ,   nulep_dphi(pdfs, pdf1d_dl_names.at(PDF1_dl::nulep_dphi))
+    ,   b1b2(pdfs, "pdf_b1b2")
+    ,   b1_pt(pdfs, pdf2d_dl_names.at(PDF2_dl::b1_pt))
+    {}
+
+    PDFHandle<TH1> b1;
+    PDFHandle<TH1> b2;
+    PDFHandle<TH1> mbb;
+    PDFHandle<TH1> mw_onshell;
+    PDFHandle<TH1> mw_offshell;
+    PDFHandle<TH1> nulep_deta;
+    PDFHandle<TH1> nulep_dphi;
+    PDFHandle<TH2> b1b2;
+    PDFHandle<TH2> b1_pt;
+};
+
+// jets outside of pt range of conditional PDFs go to the first or last pt bin, as in the sampler
+inline double CondJetPt(TLorentzVector const& jet)
+{
+    return std::clamp<double>(jet.Pt(), MIN_COND_JET_PT, MAX_COND_JET_PT - 1e-3);
+}
+
+// returns true if event passed selection and was used
+// rg is used by the sampled dijet rescaling, the default method of DijetScales
+bool FillSL(EventReader const& evt, HandlesSL const& h, TRandom3& rg)
+{
+    if (evt.ncentralJet < 4)
+    {
+        return false;
+    }
+
+    TLorentzVector genb1_p4 = evt.genb1.P4();
+    TLorentzVector genb2_p4 = evt.genb2.P4();
+    TLorentzVector genq1_p4 = evt.genV2prod1.P4();
+    TLorentzVector genq2_p4 = evt.genV2prod2.P4();
+
+    if (genb1_p4.DeltaR(genb2_p4) < 0.4 || genq1_p4.DeltaR(genq2_p4) < 0.4)
+    {
+        return false;
+    }
+
+    if (!CorrectLepReco(evt.lep1_type, evt.lep1_genLep_kind))
+    {
+        return false;
+    }
+
+    std::vector<TLorentzVector> const& jets = evt.jets;
+    Assignment match = evt.has_match_sl ? evt.match_sl.ToAssignment() : MatchPartons(std::vector<TLorentzVector>{genb1_p4, genb2_p4, genq1_p4, genq2_p4}, jets);
+    if (!match.IsComplete())
+    {
+        return false;
+    }
+
+    int b1_match = match.jets[0];
+    int b2_match = match.jets[1];
+    int q1_match = match.jets[2];
+    int q2_match = match.jets[3];
+
+    TLorentzVector reco_lep_p4;
+    reco_lep_p4.SetPtEtaPhiM(evt.lep1_pt, evt.lep1_eta, evt.lep1_phi, evt.lep1_mass);
+
+    TLorentzVector const& reco_bj1_p4 = jets[b1_match];
+    TLorentzVector const& reco_bj2_p4 = jets[b2_match];
+    TLorentzVector const& reco_lj1_p4 = jets[q1_match];
+    TLorentzVector const& reco_lj2_p4 = jets[q2_match];
+
+    TLorentzVector Hbb_p4 = evt.genHbb.P4();
+    TLorentzVector Hww_p4 = evt.genHVV.P4();
+    h.hh_dphi.Fill(Hbb_p4.DeltaPhi(Hww_p4));
+    h.hh_dEtadPhi.Fill(Hbb_p4.Eta() - Hww_p4.Eta(), Hbb_p4.DeltaPhi(Hww_p4));
+    h.hh_deta.Fill(Hbb_p4.Eta() - Hww_p4.Eta());
+
+    h.hbb_pt_e.Fill(Hbb_p4.Pt()/Hbb_p4.E());
+    h.hww_pt_e.Fill(Hww_p4.Pt()/Hww_p4.E());
+    h.hh_pt_e.Fill(Hbb_p4.Pt()/Hbb_p4.E(), Hww_p4.Pt()/Hww_p4.E());
+
+    TLorentzVector reco_met;
+    reco_met.SetPtEtaPhiM(evt.PuppiMET_pt, 0.0, evt.PuppiMET_phi, 0.0);
+
+    TLorentzVector nu = evt.genV1prod2.P4();
+
+    double genV1_mass = evt.genV1_mass.Get();
+    double genV2_mass = evt.genV2_mass.Get();
+
+    double c1 = genb1_p4.Pt()/reco_bj1_p4.Pt();
+    double c2 = genb2_p4.Pt()/reco_bj2_p4.Pt();
+
+    double c3 = genq1_p4.Pt()/reco_lj1_p4.Pt();
+    double c4 = genq2_p4.Pt()/reco_lj2_p4.Pt();
+
+    double dpx_b_resc = -(c1 - 1)*reco_bj1_p4.Px() - (c2 - 1)*reco_bj2_p4.Px();
+    double dpy_b_resc = -(c1 - 1)*reco_bj1_p4.Py() - (c2 - 1)*reco_bj2_p4.Py();
+
+    double dpx_l_resc = -(c3 - 1)*reco_lj1_p4.Px() - (c4 - 1)*reco_lj2_p4.Px();
+    double dpy_l_resc = -(c3 - 1)*reco_lj1_p4.Py() - (c4 - 1)*reco_lj2_p4.Py();
+
+    // MET smearing and light jet resolution shifts of MET enter as their most probable values
+    // both are zero-mean gaussians (light jet corrections are truncated at pt = 0, which does not move the mode),
+    // so the modes are zero and the corresponding terms drop out of the MET correction
+    TLorentzVector reco_Wlep_p4 = reco_lep_p4 + nu;
+    auto [s1, s2] = DijetScales(reco_lj1_p4, evt.jet_resolutions[q1_match], reco_lj2_p4, evt.jet_resolutions[q2_match], genV2_mass, rg);
+    TLorentzVector reco_Whad_p4 = ScalePt(reco_lj1_p4, s1) + ScalePt(reco_lj2_p4, s2);
+    TLorentzVector reco_Hww_p4 = reco_Whad_p4 + reco_Wlep_p4;
+    h.mww_narrow.Fill(reco_Hww_p4.M());
+
+    double hww_mass = (reco_Wlep_p4 + reco_lj1_p4 + reco_lj2_p4).M();
+    h.mww_wide.Fill(hww_mass);
+
+    if (genV1_mass > genV2_mass)
+    {
+        h.mjj_off.Fill((reco_lj1_p4 + reco_lj2_p4).M());
+    }
+    else
+    {
+        h.mjj_on.Fill((reco_lj1_p4 + reco_lj2_p4).M());
+    }
+
+    double met_corr_px = reco_met.Px() + dpx_b_resc;
+    double met_corr_py = reco_met.Py() + dpy_b_resc;
+    double met_corr_pt = std::sqrt(met_corr_px*met_corr_px + met_corr_py*met_corr_py);
+    double met_corr_phi = std::atan2(met_corr_py, met_corr_px);
+    TLorentzVector reco_met_corr;
+    reco_met_corr.SetPtEtaPhiM(met_corr_pt, 0.0, met_corr_phi, 0.0);
+
+    double met_corr_px_ext = reco_met.Px() + dpx_b_resc + dpx_l_resc;
+    double met_corr_py_ext = reco_met.Py() + dpy_b_resc + dpy_l_resc;
+    double met_corr_pt_ext = std::sqrt(met_corr_px_ext*met_corr_px_ext + met_corr_py_ext*met_corr_py_ext);
+    double met_corr_phi_ext = std::atan2(met_corr_py_ext, met_corr_px_ext);
+    TLorentzVector reco_met_corr_ext;
+    reco_met_corr_ext.SetPtEtaPhiM(met_corr_pt_ext, 0.0, met_corr_phi_ext, 0.0);
+
+    h.numet_pt.Fill(nu.Pt()/reco_met_corr.Pt());
+    h.numet_dphi.Fill(nu.DeltaPhi(reco_met_corr));
+    h.numet_pt_ext.Fill(nu.Pt()/reco_met_corr_ext.Pt());
+    h.numet_dphi_ext.Fill(nu.DeltaPhi(reco_met_corr_ext));
+    h.b1.Fill(c1);
+    h.b2.Fill(c2);
+    h.q1.Fill(c3);
+    h.q2.Fill(c4);
+    h.b1b2.Fill(c1, c2);
+    h.q1q2.Fill(c3, c4);
+    h.b1_pt.Fill(c1, CondJetPt(reco_bj1_p4));
+    h.q1_pt.Fill(c3, CondJetPt(reco_lj1_p4));
+    h.mbb.Fill((c1*reco_bj1_p4 + c2*reco_bj2_p4).M());
+    h.nulep_deta.Fill(nu.Eta() - reco_lep_p4.Eta());
+    h.mw1mw2.Fill(std::max(genV1_mass, genV2_mass), std::min(genV1_mass, genV2_mass));
+    return true;
+}
+
+bool FillDL(EventReader const& evt, HandlesDL const& h)
+{
+    if (evt.ncentralJet < 2)
+    {
+        return false;
+    }
+
+    TLorentzVector genb1_p4 = evt.genb1.P4();
+    TLorentzVector genb2_p4 = evt.genb2.P4();
+
+    if (genb1_p4.DeltaR(genb2_p4) < 0.4)
+    {
+        return false;
+    }
+
+    bool correct_leptons = CorrectLepReco(evt.lep1_type, evt.lep1_genLep_kind) && CorrectLepReco(evt.lep2_type, evt.lep2_genLep_kind);
+    if (!correct_leptons)
+    {
+        return false;
+    }
+
+    std::vector<TLorentzVector> const& jets = evt.jets;
+    Assignment match = evt.has_match_dl ? evt.match_dl.ToAssignment() : MatchPartons(std::vector<TLorentzVector>{genb1_p4, genb2_p4}, jets);
+    if (!match.IsComplete())
+    {
+        return false;
+    }
+
+    int b1_match = match.jets[0];
+    int b2_match = match.jets[1];
+
+    TLorentzVector const& reco_bj1_p4 = jets[b1_match];
+    TLorentzVector const& reco_bj2_p4 = jets[b2_match];
+
+    double c1 = genb1_p4.Pt()/reco_bj1_p4.Pt();
+    double c2 = genb2_p4.Pt()/reco_bj2_p4.Pt();
+
+    double genV1_mass = evt.genV1_mass.Get();
+    double genV2_mass = evt.genV2_mass.Get();
+
+    // prod1 is lepton, prod2 is neutrino
+    if (genV1_mass > genV2_mass)
+    {
+        h.mw_onshell.Fill(genV1_mass);
+        h.mw_offshell.Fill(genV2_mass);
+
+        h.nulep_deta.Fill(evt.genV1prod2.eta.Get() - evt.genV1prod1.eta.Get());
+        h.nulep_dphi.Fill(TVector2::Phi_mpi_pi(evt.genV1prod2.phi.Get() - evt.genV1prod1.phi.Get()));
+    }
+    else
+    {
+        h.mw_onshell.Fill(genV2_mass);
+        h.mw_offshell.Fill(genV1_mass);
+
+        h.nulep_deta.Fill(evt.genV2prod2.eta.Get() - evt.genV2prod1.eta.Get());
+        h.nulep_dphi.Fill(TVector2::Phi_mpi_pi(evt.genV2prod2.phi.Get() - evt.genV2prod1.phi.Get()));
+    }
+
+    h.b1.Fill(c1);
+    h.b2.Fill(c2);
+    h.b1b2.Fill(c1, c2);
+    h.b1_pt.Fill(c1, CondJetPt(reco_bj1_p4));
+    h.mbb.Fill((c1*reco_bj1_p4 + c2*reco_bj2_p4).M());
+    return true;
+}
+
+// file from shared input list together with channels it is used for
+struct InputFile
+{
+    TString name;
+    bool sl = false;
+    bool dl = false;
+};
+
+// union of SL and DL file lists, file present in both lists is read once
+std::vector<InputFile> MakeInputList(std::vector<TString> const& files_sl, std::vector<TString> const& files_dl)
+{
+    std::vector<InputFile> inputs;
+    auto add = [&inputs](TString const& name, Channel ch)
+    {
+        auto it = std::find_if(inputs.begin(), inputs.end(), [&name](InputFile const& f) { return f.name == name; });
+        if (it == inputs.end())
+        {
+            inputs.push_back({name});
+            it = std::prev(inputs.end());
+        }
+        (ch == Channel::SL ? it->sl : it->dl) = true;
+    };
+
+    for (auto const& f: files_sl)
+    {
+        add(f, Channel::SL);
+    }
+    for (auto const& f: files_dl)
+    {
+        add(f, Channel::DL);
+    }
+    return inputs;
+}
+
+// decodes every event of the file once and passes it to fillers of all requested channels
+// quark to jet matching is read from friend trees written by match_tree when they exist next to the file
+// in bootstrap mode bins filled by selected events are added to replicas of the accumulator
+// with per-event Poisson weights, so all replicas are built in the same pass
+void FillFromFile(InputFile const& input, PDFAccumulator& acc)
+{
+    auto file = std::unique_ptr<TFile>(TFile::Open(input.name));
+    if (!file || file->IsZombie())
+    {
+        throw std::runtime_error("Unable to open file " + std::string(input.name.Data()));
+    }
+
+    TTree* tree = static_cast<TTree*>(file->Get("Events"));
+    if (!tree)
+    {
+        throw std::runtime_error("No tree Events in file " + std::string(input.name.Data()));
+    }
+
+    EventReader evt(tree, input.sl, input.dl);
+    evt.AttachMatches(input.name, input.sl, input.dl);
+    HandlesSL handles_sl(acc.sl);
+    HandlesDL handles_dl(acc.dl);
+
+    PoissonWeights weights(acc.n_replicas, acc.bootstrap_seed);
+    weights.SetFile(input.name);
+
+    // seeded per file, so sampled dijet rescaling does not depend on which thread processes the file
+    TRandom3 rg(static_cast<UInt_t>(Mix64(SEED ^ HashName(input.name))));
+
+    Long64_t n_events = evt.GetEntries();
+    acc.n_events += n_events;
+    for (Long64_t i = 0; i < n_events; ++i)
+    {
+        evt.GetEntry(i);
+
+        if (input.sl && FillSL(evt, handles_sl, rg))
+        {
+            ++acc.n_selected_sl;
+        }
+
+        if (input.dl && FillDL(evt, handles_dl))
+        {
+            ++acc.n_selected_dl;
+        }
+
+        if (acc.sl.HasPending() || acc.dl.HasPending())
+        {
+            Float_t const* w = weights.Generate(i);
+            acc.sl.CommitReplicas(w);
+            acc.dl.CommitReplicas(w);
+        }
+    }
+
+    acc.sl.FlushReplicas();
+    acc.dl.FlushReplicas();
+}
+
+// partial accumulator of input file: path with separators replaced, so files with equal names in different directories do not clash
+TString PartialFileName(TString const& partial_dir, TString const& input_name)
+{
+    std::string name = input_name.Data();
+    std::replace_if(name.begin(), name.end(), [](char c) { return c == '/' || c == ':'; }, '_');
+    name.erase(0, name.find_first_not_of('_'));
+    return partial_dir + "/" + name.c_str();
+}
+
+Provenance MakeProvenance(InputFile const& input, int n_replicas, std::uint64_t bootstrap_seed)
+{
+    Provenance prov;
+    prov.source = input.name;
+    prov.sl = input.sl;
+    prov.dl = input.dl;
+    prov.n_replicas = n_replicas;
+    prov.bootstrap_seed = n_replicas > 0 ? bootstrap_seed : 0;
+
+    std::error_code ec;
+    std::filesystem::path path(input.name.Data());
+    auto size = std::filesystem::file_size(path, ec);
+    if (!ec)
+    {
+        prov.source_size = size;
+    }
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (!ec)
+    {
+        prov.source_mtime = mtime.time_since_epoch().count();
+    }
+    return prov;
+}
+
+// partial is reused only if it was built by the same builder version from unchanged source for the same channels
+bool IsUpToDate(TString const& partial_file, Provenance const& prov)
+{
+    if (!std::filesystem::exists(partial_file.Data()))
+    {
+        return false;
+    }
+
+    auto file = std::unique_ptr<TFile>(TFile::Open(partial_file));
+    if (!file || file->IsZombie())
+    {
+        return false;
+    }
+
+    try
+    {
+        return PDFAccumulator::ReadProvenance(file.get()) == prov;
+    }
+    catch (std::runtime_error const&)
+    {
+        return false;
+    }
+}
+
+// usage: pdfs [n_threads] [partial_dir] [n_replicas] [bootstrap_seed]
+// only input files without up to date partial accumulator in partial_dir are processed,
+// then all partials are merged in input list order and normalized
+// with n_replicas > 0 output files also contain n_replicas bootstrap replicas of every PDF in directory "bootstrap"
+int main(int argc, char* argv[])
+{
+    unsigned n_threads = std::thread::hardware_concurrency();
+    if (argc > 1)
+    {
+        n_threads = std::stoi(argv[1]);
+    }
+
+    TString partial_dir = "partials";
+    if (argc > 2)
+    {
+        partial_dir = argv[2];
+    }
+
+    int n_replicas = 0;
+    if (argc > 3)
+    {
+        n_replicas = std::stoi(argv[3]);
+    }
+
+    std::uint64_t bootstrap_seed = SEED;
+    if (argc > 4)
+    {
+        bootstrap_seed = std::stoull(argv[4]);
+    }
+    std::filesystem::create_directories(partial_dir.Data());
+
+    ValidateRegistry(PDFSet(PDFDefsSL()), PDFSet(PDFDefsDL()));
+
+    auto inputs = MakeInputList(ReadFileList("files_sl.txt"), ReadFileList("files_dl.txt"));
+    std::vector<TString> partial_files;
+    std::vector<Provenance> provenances;
+    std::vector<size_t> stale;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        partial_files.push_back(PartialFileName(partial_dir, inputs[i].name));
+        provenances.push_back(MakeProvenance(inputs[i], n_replicas, bootstrap_seed));
+        if (!IsUpToDate(partial_files.back(), provenances.back()))
+        {
+            stale.push_back(i);
+        }
+    }
+    std::cout << "Processing " << stale.size() << " of " << inputs.size() << " files on " << n_threads << " threads";
+    if (n_replicas > 0)
+    {
+        std::cout << " with " << n_replicas << " bootstrap replicas";
+    }
+    std::cout << "\n";
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<Long64_t> n_events{0};
+    ForEachParallel(stale.size(), n_threads, [&](size_t k)
+    {
+        size_t idx = stale[k];
+        PDFAccumulator acc;
+        acc.BookReplicas(n_replicas, bootstrap_seed);
+        FillFromFile(inputs[idx], acc);
+
+        // partial appears under its final name only when it is complete
+        TString tmp_file = partial_files[idx] + ".tmp";
+        acc.WritePartial(tmp_file, provenances[idx]);
+        std::filesystem::rename(tmp_file.Data(), partial_files[idx].Data());
+        n_events += acc.n_events;
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Processed " << n_events << " events in " << elapsed.count() << " s, " << n_events/elapsed.count() << " events/s\n";
+
+    start = std::chrono::steady_clock::now();
+    auto pdfs = MergePartials(partial_files);
+    pdfs->Finalize();
+    WritePDFs(*pdfs, "pdf_sl.root", "pdf_dl.root");
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Merged " << partial_files.size() << " partials with " << pdfs->n_events << " events (" << pdfs->n_selected_sl << " SL, "
+              << pdfs->n_selected_dl << " DL selected) in " << elapsed.count() << " s\n";
+
+    return 0;
+}